@@ -0,0 +1,50 @@
+// File growth cost of FileMgr::append.
+//
+// Appends num_blocks blocks to a fresh file with several extent sizes.
+// extent 0 is the old behavior: every append writes a zero-filled block.
+// With extents, space is reserved with fallocate and an append inside a
+// reserved extent only updates the file size. The "append+write" rows also
+// write the new block, as TableScan::move_to_new_block() and
+// LogMgr::append_new_block() do.
+//
+// Usage: bench_append [num_blocks]
+
+#include "bench_util.hpp"
+#include "file/filemgr.hpp"
+#include <cstdlib>
+
+using file::FileMgr;
+using file::FileMgrOptions;
+using file::Page;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t num_blocks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16384;
+
+    std::printf("block size %zu, %zu blocks\n", BLOCK_SIZE, num_blocks);
+
+    for (size_t extent : {size_t(0), size_t(64) << 10, size_t(1) << 20, size_t(8) << 20}) {
+        bench::ScratchDir dir("append");
+        FileMgrOptions options;
+        options.extent_size = extent;
+        FileMgr fm(dir.path(), BLOCK_SIZE, options);
+        Page page(BLOCK_SIZE);
+        page.set_int(0, 1);
+
+        std::string label = "extent " + std::to_string(extent >> 10) + " KB";
+
+        bench::Timer t;
+        for (size_t i = 0; i < num_blocks; i++) fm.append("grow.tbl");
+        bench::report(label + " append", num_blocks, t.elapsed_ns());
+
+        t.reset();
+        for (size_t i = 0; i < num_blocks; i++) fm.write(fm.append("grow.log"), page);
+        bench::report(label + " append+write", num_blocks, t.elapsed_ns());
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Effect of the background writer on foreground pins.
+//
+// One foreground thread pins random blocks of a file much larger than the
+// pool; a share of the pins modify the page under a fresh log record, and
+// each pin is followed by a short busy "think time" standing in for query
+// work. Without the writer, most misses evict a dirty page and pay for
+// its write (and possibly a log flush). With it, dirty pages are written
+// in the background and misses find clean victims. Each row reports pin
+// latency, the share of evictions that found a clean page, and the
+// writer's rate.
+//
+// Usage: bench_bgwriter [pins] [write_percent] [think_us] [writer_batch] [writer_interval_ms]
+
+#include "bench_util.hpp"
+#include "buffer/buffermgr.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using file::BlockId;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+constexpr size_t NUM_BLOCKS = 8192;
+constexpr size_t POOL_FRAMES = 512;
+
+volatile uint64_t sink;
+
+uint64_t next_random(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+void think(double us) {
+    bench::Timer t;
+    uint64_t x = 0;
+    while (t.elapsed_ns() < us * 1000.0) {
+        x++;
+    }
+    sink = x;
+}
+
+void run(std::shared_ptr<file::FileMgr> fm, std::shared_ptr<log::LogMgr> lm, file::FileId file,
+         const buffer::BufferMgrOptions& options, size_t pins, size_t write_percent,
+         double think_us, const char* label) {
+    buffer::BufferMgr bm(fm, lm, POOL_FRAMES, options);
+    std::vector<uint8_t> rec(64, 0xab);
+    std::vector<double> latencies;
+    latencies.reserve(pins);
+
+    uint64_t rng = 7;
+    for (size_t i = 0; i < pins; i++) {
+        auto b = static_cast<int32_t>(next_random(rng) % NUM_BLOCKS);
+        bench::Timer t;
+        size_t idx = bm.pin(BlockId(file, b));
+        latencies.push_back(t.elapsed_ns() / 1000.0);
+        if (next_random(rng) % 100 < write_percent) {
+            buffer::Buffer& buff = bm.buffer(idx);
+            buff.contents().set_int(0, static_cast<int32_t>(i));
+            buff.set_modified(1, lm->append(rec));
+        }
+        think(think_us);
+        bm.unpin(idx);
+    }
+    double rate = bm.writer_rate();
+    bm.flush_all(1);
+
+    std::sort(latencies.begin(), latencies.end());
+    double mean = 0;
+    for (double l : latencies) mean += l;
+    mean /= static_cast<double>(latencies.size());
+    buffer::BufferStats stats = bm.stats();
+    size_t evictions = stats.clean_evictions + stats.dirty_evictions;
+    std::printf("%-10s %10.1f %10.1f %10.1f %12.1f%% %12.0f\n", label, mean,
+                latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100],
+                evictions ? 100.0 * static_cast<double>(stats.clean_evictions) /
+                                static_cast<double>(evictions)
+                          : 100.0,
+                rate);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t pins = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    size_t write_percent = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 30;
+    double think_us = argc > 3 ? std::strtod(argv[3], nullptr) : 20.0;
+    size_t batch = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 256;
+    uint64_t interval = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 5;
+
+    bench::ScratchDir dir("bgwriter");
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE);
+    auto lm = std::make_shared<log::LogMgr>(fm, "bench.log");
+    file::Page page(BLOCK_SIZE);
+    for (size_t i = 0; i < NUM_BLOCKS; i++) {
+        fm->write(fm->append("data.tbl"), page);
+    }
+    const file::FileId file = fm->file_id("data.tbl");
+
+    std::printf("%zu pins, %zu%% writes, %.0f us think time, %zu frames, %zu blocks\n", pins,
+                write_percent, think_us, POOL_FRAMES, NUM_BLOCKS);
+    std::printf("%-10s %10s %10s %10s %13s %12s\n", "writer", "mean us", "p50 us", "p99 us",
+                "clean evict", "writes/s");
+
+    buffer::BufferMgrOptions off;
+    off.policy = buffer::ReplacementKind::Clock;
+    run(fm, lm, file, off, pins, write_percent, think_us, "off");
+
+    buffer::BufferMgrOptions on = off;
+    on.background_writer = true;
+    on.writer_batch = batch;
+    on.writer_interval_ms = interval;
+    run(fm, lm, file, on, pins, write_percent, think_us, "on");
+    return 0;
+}
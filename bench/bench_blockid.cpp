@@ -0,0 +1,110 @@
+// Cost of the BlockId operations on the buffer-pool lookup path.
+//
+// The "legacy" rows use a copy of the old BlockId layout (std::string
+// filename + block number, string compare, string hash); the "interned"
+// rows use file::BlockId, which holds a FileId from FileRegistry.
+// Measured: copy, equality against a pool of resident blocks (what
+// BufferMgr::find_existing_buffer does), and unordered_set lookup.
+//
+// Usage: bench_blockid [pool_size] [lookups]
+
+#include "bench_util.hpp"
+#include "file/blockid.hpp"
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using file::BlockId;
+
+namespace {
+
+struct LegacyBlockId {
+    std::string filename;
+    int32_t blknum;
+
+    bool operator==(const LegacyBlockId& o) const {
+        return filename == o.filename && blknum == o.blknum;
+    }
+};
+
+struct LegacyHash {
+    size_t operator()(const LegacyBlockId& b) const noexcept {
+        size_t h1 = std::hash<std::string>()(b.filename);
+        size_t h2 = std::hash<int32_t>()(b.blknum);
+        return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+    }
+};
+
+volatile size_t sink;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t pool = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    size_t lookups = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+
+    // Table names long enough to defeat the small-string optimization
+    const std::vector<std::string> files = {"enrollment_history.tbl", "student_records.tbl",
+                                            "course_sections.tbl", "department.tbl"};
+    std::mt19937 rng(42);
+    std::vector<LegacyBlockId> legacy;
+    std::vector<BlockId> interned;
+    for (size_t i = 0; i < pool; i++) {
+        const std::string& f = files[i % files.size()];
+        legacy.push_back({f, static_cast<int32_t>(i)});
+        interned.emplace_back(f, static_cast<int32_t>(i));
+    }
+    std::vector<size_t> probes(lookups);
+    for (auto& p : probes) p = rng() % pool;
+
+    std::printf("pool %zu blocks, %zu lookups\n", pool, lookups);
+
+    bench::Timer t;
+    size_t acc = 0;
+    for (size_t p : probes) {
+        LegacyBlockId copy = legacy[p];
+        acc += static_cast<size_t>(copy.blknum);
+    }
+    bench::report("legacy copy", lookups, t.elapsed_ns());
+
+    t.reset();
+    for (size_t p : probes) {
+        BlockId copy = interned[p];
+        acc += static_cast<size_t>(copy.number());
+    }
+    bench::report("interned copy", lookups, t.elapsed_ns());
+
+    t.reset();
+    for (size_t p : probes) {
+        const LegacyBlockId& key = legacy[p];
+        for (const auto& b : legacy) {
+            if (b == key) { acc++; break; }
+        }
+    }
+    bench::report("legacy linear scan", lookups, t.elapsed_ns());
+
+    t.reset();
+    for (size_t p : probes) {
+        const BlockId& key = interned[p];
+        for (const auto& b : interned) {
+            if (b == key) { acc++; break; }
+        }
+    }
+    bench::report("interned linear scan", lookups, t.elapsed_ns());
+
+    std::unordered_set<LegacyBlockId, LegacyHash> legacy_set(legacy.begin(), legacy.end());
+    std::unordered_set<BlockId> interned_set(interned.begin(), interned.end());
+
+    t.reset();
+    for (size_t p : probes) acc += legacy_set.count(legacy[p]);
+    bench::report("legacy hash lookup", lookups, t.elapsed_ns());
+
+    t.reset();
+    for (size_t p : probes) acc += interned_set.count(interned[p]);
+    bench::report("interned hash lookup", lookups, t.elapsed_ns());
+
+    sink = acc;
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Pin/unpin throughput of a shared BufferMgr from 1 to 32 threads.
+//
+// Every thread pins and unpins random blocks of one file. In the "hits"
+// rows the working set fits in the pool, so after warm-up every pin is a
+// page-table hit; in the "10% miss" rows the working set is larger than
+// the pool and misses read the block from the file. Each row compares a
+// pool with a single partition (one latch for everything, the baseline)
+// against one split into many partitions.
+//
+// Usage: bench_buffer_threads [pool_frames] [partitions] [pins_per_thread]
+
+#include "bench_util.hpp"
+#include "buffer/buffermgr.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using file::BlockId;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+constexpr size_t MAX_THREADS = 32;
+
+uint64_t next_random(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Returns pins per microsecond over all threads
+double run(std::shared_ptr<file::FileMgr> fm, std::shared_ptr<log::LogMgr> lm,
+           file::FileId file, size_t frames, size_t partitions, size_t nthreads,
+           size_t working_set, size_t pins) {
+    buffer::BufferMgrOptions options;
+    options.policy = buffer::ReplacementKind::Clock;
+    options.partitions = partitions;
+    buffer::BufferMgr bm(fm, lm, frames, options);
+    for (size_t i = 0; i < std::min(frames, working_set); i++) {
+        bm.unpin(bm.pin(BlockId(file, static_cast<int32_t>(i))));
+    }
+
+    bench::Timer t;
+    std::vector<std::thread> threads;
+    for (size_t th = 0; th < nthreads; th++) {
+        threads.emplace_back([&, th] {
+            uint64_t rng = 0x9e3779b97f4a7c15ULL * (th + 1);
+            for (size_t i = 0; i < pins; i++) {
+                auto b = static_cast<int32_t>(next_random(rng) % working_set);
+                bm.unpin(bm.pin(BlockId(file, b)));
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    return static_cast<double>(nthreads * pins) / (t.elapsed_ns() / 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    size_t partitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+    size_t pins = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 200000;
+
+    bench::ScratchDir dir("buffer_threads");
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE);
+    auto lm = std::make_shared<log::LogMgr>(fm, "bench.log");
+
+    // Large enough that about 10% of uniform pins miss a full pool
+    size_t miss_set = frames * 10 / 9;
+    file::Page page(BLOCK_SIZE);
+    for (size_t i = 0; i < miss_set; i++) {
+        fm->write(fm->append("shared.tbl"), page);
+    }
+    const file::FileId file = fm->file_id("shared.tbl");
+
+    std::printf("%zu frames, %zu pins per thread, %u hardware threads\n", frames, pins,
+                std::thread::hardware_concurrency());
+    std::printf("%-10s %-8s %18s %18s\n", "workload", "threads", "1 partition Mpin/s",
+                (std::to_string(partitions) + " partitions Mpin/s").c_str());
+
+    struct Workload {
+        const char* name;
+        size_t working_set;
+    };
+    for (const Workload& w : {Workload{"hits", frames}, Workload{"10% miss", miss_set}}) {
+        for (size_t n = 1; n <= MAX_THREADS; n *= 2) {
+            double single = run(fm, lm, file, frames, 1, n, w.working_set, pins);
+            double split = run(fm, lm, file, frames, partitions, n, w.working_set, pins);
+            std::printf("%-10s %-8zu %18.2f %18.2f\n", w.name, n, single, split);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Commit latency of BufferMgr::flush_all() against pool size.
+//
+// Each commit pins a few random blocks, modifies them under a fresh log
+// record, unpins them and calls flush_all() for its transaction number.
+// The pool is filled first so that every frame holds a page. Data and log
+// files are not synced unless requested, so the rows show the cost of
+// finding and writing the transaction's pages rather than of fsync; with
+// per-transaction dirty lists the latency should not grow with the pool.
+//
+// Usage: bench_commit [commits] [pages_per_commit] [sync]
+
+#include "bench_util.hpp"
+#include "buffer/buffermgr.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using file::BlockId;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 512;
+constexpr size_t FILE_BLOCKS = 4096;
+
+uint64_t next_random(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+void run(size_t frames, size_t commits, size_t pages, bool sync) {
+    bench::ScratchDir dir("commit");
+    file::FileMgrOptions fopts;
+    if (!sync) {
+        fopts.log_sync = file::SyncPolicy::None;
+        fopts.data_sync = file::SyncPolicy::None;
+    }
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE, fopts);
+    auto lm = std::make_shared<log::LogMgr>(fm, "bench.log");
+    file::Page page(BLOCK_SIZE);
+    for (size_t i = 0; i < FILE_BLOCKS; i++) {
+        fm->write(fm->append("data.tbl"), page);
+    }
+    const file::FileId file = fm->file_id("data.tbl");
+
+    // Fill every frame: the blocks past the end of the file read as zeros
+    bench::Timer fill;
+    buffer::BufferMgr bm(fm, lm, frames);
+    for (size_t i = 0; i < frames; i++) {
+        bm.unpin(bm.pin(BlockId(fm->file_id("fill.tbl"), static_cast<int32_t>(i))));
+    }
+    double fill_ms = fill.elapsed_ns() / 1e6;
+
+    std::vector<uint8_t> rec(32, 0xcd);
+    std::vector<double> latencies;
+    latencies.reserve(commits);
+    uint64_t rng = 11;
+    for (size_t tx = 1; tx <= commits; tx++) {
+        for (size_t p = 0; p < pages; p++) {
+            auto b = static_cast<int32_t>(next_random(rng) % FILE_BLOCKS);
+            size_t idx = bm.pin(BlockId(file, b));
+            buffer::Buffer& buff = bm.buffer(idx);
+            buff.contents().set_int(0, static_cast<int32_t>(tx));
+            buff.set_modified(tx, lm->append(rec));
+            bm.unpin(idx);
+        }
+        bench::Timer t;
+        bm.flush_all(tx);
+        latencies.push_back(t.elapsed_ns() / 1000.0);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double mean = 0;
+    for (double l : latencies) mean += l;
+    mean /= static_cast<double>(latencies.size());
+    std::printf("%10zu %10.1f %10.1f %10.1f %12.1f\n", frames, mean,
+                latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], fill_ms);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t commits = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    size_t pages = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2;
+    bool sync = argc > 3 && std::string(argv[3]) == "sync";
+
+    std::printf("%zu commits of %zu pages, %s\n", commits, pages,
+                sync ? "synced" : "no sync");
+    std::printf("%10s %10s %10s %10s %12s\n", "frames", "mean us", "p50 us", "p99 us",
+                "fill ms");
+    for (size_t frames : {size_t{1000}, size_t{10000}, size_t{100000}, size_t{1000000}}) {
+        run(frames, commits, pages, sync);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Per-block read and write latency of FileMgr.
+//
+// The "legacy" rows replay the access pattern FileMgr used before it kept an
+// open-file table: a fresh std::fstream per block, an exists() check, a seek
+// to the end to find the size, and a stat after every write. The "filemgr"
+// rows go through the current FileMgr (cached descriptors, pread/pwrite).
+//
+// Usage: bench_filemgr [num_blocks] [passes]
+
+#include "bench_util.hpp"
+#include "file/filemgr.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace fs = std::filesystem;
+using file::BlockId;
+using file::FileMgr;
+using file::Page;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+
+void legacy_read(const std::string& path, int32_t blknum, Page& page) {
+    if (!fs::exists(path)) return;
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekg(0, std::ios::end);
+    size_t file_size = f.tellg();
+    size_t pos = static_cast<size_t>(blknum) * BLOCK_SIZE;
+    if (pos + page.size() > file_size) return;
+    f.seekg(pos, std::ios::beg);
+    f.read(reinterpret_cast<char*>(page.contents()), page.size());
+}
+
+void legacy_write(const std::string& path, int32_t blknum, Page& page) {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(static_cast<size_t>(blknum) * BLOCK_SIZE, std::ios::beg);
+    f.write(reinterpret_cast<const char*>(page.contents()), page.size());
+    f.flush();
+    (void)fs::file_size(path);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t num_blocks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+    size_t passes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+
+    bench::ScratchDir dir("filemgr");
+    FileMgr fm(dir.path(), BLOCK_SIZE);
+    const std::string filename = "bench.tbl";
+    const std::string path = dir.path() + "/" + filename;
+
+    for (size_t i = 0; i < num_blocks; i++) {
+        fm.append(filename);
+    }
+
+    // Random block order, shared by every run so they touch the same blocks
+    std::vector<int32_t> order(num_blocks);
+    for (size_t i = 0; i < num_blocks; i++) order[i] = static_cast<int32_t>(i);
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    Page page(BLOCK_SIZE);
+    size_t ops = num_blocks * passes;
+
+    std::printf("block size %zu, %zu blocks, %zu passes\n", BLOCK_SIZE, num_blocks, passes);
+
+    bench::Timer t;
+    for (size_t p = 0; p < passes; p++)
+        for (int32_t b : order) legacy_read(path, b, page);
+    bench::report("legacy fstream read", ops, t.elapsed_ns());
+
+    t.reset();
+    for (size_t p = 0; p < passes; p++)
+        for (int32_t b : order) fm.read(BlockId(filename, b), page);
+    bench::report("filemgr pread read", ops, t.elapsed_ns());
+
+    t.reset();
+    for (size_t p = 0; p < passes; p++)
+        for (int32_t b : order) legacy_write(path, b, page);
+    bench::report("legacy fstream write", ops, t.elapsed_ns());
+
+    t.reset();
+    for (size_t p = 0; p < passes; p++)
+        for (int32_t b : order) fm.write(BlockId(filename, b), page);
+    bench::report("filemgr pwrite write", ops, t.elapsed_ns());
+
+    return 0;
+}
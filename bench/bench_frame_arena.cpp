@@ -0,0 +1,102 @@
+// Frame memory layouts of the buffer pool: startup cost and hit throughput.
+//
+// For each FrameMemory kind, builds a BufferMgr (the "startup" column),
+// makes every frame resident once ("fill"), then pins random resident
+// blocks and reads a random integer from each page. With one allocation
+// per page the frames are scattered over the heap; the arena keeps them
+// in one mapping, which huge pages can cover with far fewer TLB entries.
+// The "mapped" column shows what the arena actually got: HugeTlb falls
+// back to HugePages when no huge pages are reserved (vm.nr_hugepages).
+//
+// Usage: bench_frame_arena [frames] [pins]
+
+#include "bench_util.hpp"
+#include "buffer/buffermgr.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <cstdlib>
+#include <memory>
+
+using file::BlockId;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+
+volatile int64_t sink;
+
+uint64_t next_random(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+const char* name(buffer::FrameMemory memory) {
+    switch (memory) {
+    case buffer::FrameMemory::Heap: return "heap";
+    case buffer::FrameMemory::Arena: return "arena";
+    case buffer::FrameMemory::HugePages: return "arena+thp";
+    case buffer::FrameMemory::HugeTlb: return "arena+hugetlb";
+    }
+    return "?";
+}
+
+void run(std::shared_ptr<file::FileMgr> fm, std::shared_ptr<log::LogMgr> lm,
+         buffer::FrameMemory memory, size_t frames, size_t pins) {
+    const file::FileId file = fm->file_id("data.tbl");
+    buffer::BufferMgrOptions options;
+    options.frame_memory = memory;
+    options.policy = buffer::ReplacementKind::Clock;
+
+    bench::Timer startup;
+    buffer::BufferMgr bm(fm, lm, frames, options);
+    double startup_ms = startup.elapsed_ns() / 1e6;
+
+    // Blocks past the end of the file read as unchanged (zero) pages
+    bench::Timer fill;
+    for (size_t i = 0; i < frames; i++) {
+        size_t idx = bm.pin(BlockId(file, static_cast<int32_t>(i)));
+        bm.buffer(idx).contents().set_int(0, static_cast<int32_t>(i));
+        bm.unpin(idx);
+    }
+    double fill_ms = fill.elapsed_ns() / 1e6;
+
+    uint64_t rng = 3;
+    int64_t sum = 0;
+    bench::Timer t;
+    for (size_t i = 0; i < pins; i++) {
+        uint64_t r = next_random(rng);
+        size_t idx = bm.pin(BlockId(file, static_cast<int32_t>(r % frames)));
+        sum += bm.buffer(idx).contents().get_int_unchecked((r >> 32) % (BLOCK_SIZE / 4) * 4);
+        bm.unpin(idx);
+    }
+    double ns = t.elapsed_ns();
+    sink = sum;
+
+    std::printf("%-14s %-14s %12.1f %12.1f %14.0f\n", name(memory), name(bm.frame_memory()),
+                startup_ms, fill_ms, static_cast<double>(pins) / (ns / 1e9));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 262144;
+    size_t pins = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000000;
+
+    bench::ScratchDir dir("frame_arena");
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE);
+    auto lm = std::make_shared<log::LogMgr>(fm, "bench.log");
+    fm->append("data.tbl");
+
+    std::printf("%zu frames of %zu bytes (%.0f MB), %zu random pins of resident blocks\n",
+                frames, BLOCK_SIZE, static_cast<double>(frames * BLOCK_SIZE) / (1 << 20), pins);
+    std::printf("%-14s %-14s %12s %12s %14s\n", "requested", "mapped", "startup ms", "fill ms",
+                "pins/s");
+    for (buffer::FrameMemory memory : {buffer::FrameMemory::Heap, buffer::FrameMemory::Arena,
+                                       buffer::FrameMemory::HugePages,
+                                       buffer::FrameMemory::HugeTlb}) {
+        run(fm, lm, memory, frames, pins);
+    }
+    return 0;
+}
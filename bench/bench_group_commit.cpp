@@ -0,0 +1,73 @@
+// Commit throughput of LogMgr::flush() with concurrent committers.
+//
+// Each committer thread repeatedly appends a small commit record and
+// flushes the log up to it, as a transaction commit does. Flushes of
+// concurrent committers are merged by group commit: "wait 0" rows only
+// merge the committers that arrive while a write is in progress, the
+// other rows let the leader wait for more. "syncs/commit" is the fraction
+// of commits that issued their own write and sync. The log is synced for
+// real (SyncPolicy::Deferred), so the rows depend on the device's fsync
+// latency.
+//
+// Usage: bench_group_commit [commits] [group_wait_us]
+
+#include "bench_util.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+
+void run(size_t committers, size_t commits, uint64_t group_wait_us) {
+    bench::ScratchDir dir("group_commit");
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE);
+    log::LogMgrOptions options;
+    options.group_max = committers;
+    options.group_wait_us = group_wait_us;
+    log::LogMgr lm(fm, "bench.log", options);
+
+    size_t per_thread = std::max<size_t>(commits / committers, 1);
+    std::vector<uint8_t> rec(48, 0xc0);
+    bench::Timer t;
+    std::vector<std::thread> threads;
+    for (size_t c = 0; c < committers; c++) {
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < per_thread; i++) {
+                lm.flush(lm.append(rec));
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    double ns = t.elapsed_ns();
+
+    size_t total = per_thread * committers;
+    log::LogStats stats = lm.stats();
+    std::printf("%10zu %8llu %14.0f %14.3f %12.1f\n", committers,
+                static_cast<unsigned long long>(group_wait_us),
+                static_cast<double>(total) / (ns / 1e9),
+                static_cast<double>(stats.group_flushes) / static_cast<double>(total),
+                static_cast<double>(fm->sync_count()) / (ns / 1e9));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t commits = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    uint64_t group_wait_us = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100;
+
+    std::printf("%zu commits split over the committers\n", commits);
+    std::printf("%10s %8s %14s %14s %12s\n", "committers", "wait us", "commits/s",
+                "syncs/commit", "syncs/s");
+    for (uint64_t wait : {uint64_t{0}, group_wait_us}) {
+        for (size_t committers : {1, 2, 4, 8, 16, 32, 64}) {
+            run(committers, commits, wait);
+        }
+    }
+    return 0;
+}
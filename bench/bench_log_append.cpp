@@ -0,0 +1,71 @@
+// Throughput of LogMgr::append() with concurrent appenders.
+//
+// Each thread appends records of a fixed size as fast as it can, with no
+// flush() calls, so the rows show the cost of reserving an LSN, copying
+// the record and rolling over to new blocks. Full blocks are written out
+// by the log flusher while appends continue, for several sizes of the
+// log buffer ring. "ring waits" counts rollovers that found the ring full
+// and had to wait for the flusher; "drained" counts blocks the flusher
+// wrote in the background before anything waited for them.
+//
+// Usage: bench_log_append [records_per_thread] [record_size]
+
+#include "bench_util.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+
+void run(size_t buffer_bytes, size_t threads, size_t records, size_t record_size) {
+    bench::ScratchDir dir("log_append");
+    file::FileMgrOptions fopts;
+    fopts.log_sync = file::SyncPolicy::None;
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE, fopts);
+    log::LogMgrOptions options;
+    options.buffer_bytes = buffer_bytes;
+    log::LogMgr lm(fm, "bench.log", options);
+
+    std::vector<uint8_t> rec(record_size, 0x5a);
+    bench::Timer t;
+    std::vector<std::thread> appenders;
+    for (size_t a = 0; a < threads; a++) {
+        appenders.emplace_back([&] {
+            for (size_t i = 0; i < records; i++) {
+                lm.append(rec);
+            }
+        });
+    }
+    for (auto& th : appenders) th.join();
+    double ns = t.elapsed_ns();
+
+    size_t total = records * threads;
+    log::LogStats stats = lm.stats();
+    std::printf("%10zu %8zu %14.0f %12.1f %12zu %10zu\n", buffer_bytes >> 10, threads,
+                static_cast<double>(total) / (ns / 1e9), ns / static_cast<double>(total),
+                stats.ring_waits, stats.drained_blocks);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t records = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t record_size = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+
+    std::printf("%zu records of %zu bytes per thread, %zu-byte log blocks, no sync\n", records,
+                record_size, BLOCK_SIZE);
+    std::printf("%10s %8s %14s %12s %12s %10s\n", "ring KB", "threads", "appends/s",
+                "ns/append", "ring waits", "drained");
+    for (size_t buffer_bytes : {size_t{32} << 10, size_t{1} << 20, size_t{4} << 20,
+                                size_t{16} << 20}) {
+        for (size_t threads : {1, 4}) {
+            run(buffer_bytes, threads, records, record_size);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+// Read-mostly access to one hot record page: optimistic vs latched reads.
+//
+// Several threads read random records of one pinned RecordPage while a
+// writer updates a record every so often. In the "latched" rows each read
+// holds the frame latch exclusively, as a reader would with a plain page
+// mutex; in the "optimistic" rows the same read runs under
+// Buffer::read_optimistic(), as RecordPage's getters do, which only checks
+// the frame version and retries when a write overlapped. The "retries"
+// column counts reads that had to run again.
+//
+// Usage: bench_optimistic_read [reads_per_thread] [reads_per_write]
+
+#include "bench_util.hpp"
+#include "buffer/buffermgr.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include "record/layout.hpp"
+#include "record/recordpage.hpp"
+#include "record/schema.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+
+volatile int64_t sink;
+
+uint64_t next_random(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+void run(buffer::Buffer& buff, const record::Layout& layout, size_t slots, bool optimistic,
+         int threads, size_t reads, size_t reads_per_write) {
+    std::atomic<bool> done{false};
+    std::atomic<size_t> retries{0};
+    std::thread writer([&] {
+        record::RecordPage rp(buff, layout);
+        uint64_t rng = 99;
+        int32_t value = 0;
+        while (!done) {
+            rp.set_int(next_random(rng) % slots, "balance", value++);
+            // Roughly one write per reads_per_write reads of all readers
+            for (size_t i = 0; i < reads_per_write / 8 && !done; i++) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bench::Timer t;
+    std::vector<std::thread> readers;
+    for (int r = 0; r < threads; r++) {
+        readers.emplace_back([&, r] {
+            uint64_t rng = 7 + static_cast<uint64_t>(r);
+            int64_t sum = 0;
+            size_t attempts = 0;
+            auto read = [&](size_t slot) {
+                attempts++;
+                size_t base = slot * layout.slot_size();
+                return buff.contents().get_int(base + layout.offset("id")) +
+                       buff.contents().get_int(base + layout.offset("balance"));
+            };
+            for (size_t i = 0; i < reads; i++) {
+                size_t slot = next_random(rng) % slots;
+                if (optimistic) {
+                    sum += buff.read_optimistic([&] { return read(slot); });
+                } else {
+                    buffer::FrameWriteLatch latch(buff);
+                    sum += read(slot);
+                }
+            }
+            retries += attempts - reads;
+            sink = sum;
+        });
+    }
+    for (auto& th : readers) th.join();
+    double ns = t.elapsed_ns();
+    done = true;
+    writer.join();
+
+    size_t total = reads * static_cast<size_t>(threads);
+    std::printf("%-11s %8d %14.0f %12.1f %10zu\n", optimistic ? "optimistic" : "latched", threads,
+                static_cast<double>(total) / (ns / 1e9), ns / static_cast<double>(reads),
+                retries.load());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t reads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t reads_per_write = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+
+    bench::ScratchDir dir("optimistic_read");
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE);
+    auto lm = std::make_shared<log::LogMgr>(fm, "bench.log");
+    buffer::BufferMgr bm(fm, lm, 8);
+
+    auto schema = std::make_shared<record::Schema>();
+    schema->add_int_field("id");
+    schema->add_int_field("balance");
+    schema->add_string_field("name", 16);
+    record::Layout layout(schema);
+
+    size_t idx = bm.pin(fm->append("hot.tbl"));
+    buffer::Buffer& buff = bm.buffer(idx);
+    record::RecordPage rp(buff, layout);
+    rp.format();
+    size_t slots = 0;
+    for (auto slot = rp.insert_after(std::nullopt); slot; slot = rp.insert_after(slot)) {
+        rp.set_int(*slot, "id", static_cast<int32_t>(*slot));
+        slots++;
+    }
+
+    std::printf("%zu records on one page, %zu reads per thread, ~1 write per %zu reads\n", slots,
+                reads, reads_per_write);
+    std::printf("%-11s %8s %14s %12s %10s\n", "reads", "threads", "reads/s", "ns/read",
+                "retries");
+    for (int threads : {1, 2, 4, 8}) {
+        run(buff, layout, slots, false, threads, reads, reads_per_write);
+        run(buff, layout, slots, true, threads, reads, reads_per_write);
+    }
+    bm.unpin(idx);
+    return 0;
+}
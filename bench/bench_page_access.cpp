@@ -0,0 +1,80 @@
+// Integer field reads through file::Page.
+//
+// Reads every int field of a page of fixed-size records, many times over:
+//   - legacy:        the old accessor (bounds check + big-endian assembly
+//                    one byte at a time), reproduced here
+//   - big-endian:    Page::get_int on a format-1 page (memcpy + bswap)
+//   - little-endian: Page::get_int on a format-2 page (memcpy)
+//   - unchecked:     Page::get_int_unchecked on a format-2 page
+// Build with optimizations (-DCMAKE_BUILD_TYPE=Release) for meaningful
+// numbers.
+//
+// Usage: bench_page_access [millions_of_reads]
+
+#include "bench_util.hpp"
+#include "file/page.hpp"
+#include <cstdlib>
+
+using file::ByteOrder;
+using file::Page;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+constexpr size_t FIELD_STRIDE = 4;
+
+int32_t legacy_get_int(const Page& page, size_t offset) {
+    if (offset + 4 > page.size()) {
+        throw std::out_of_range("Page access out of bounds");
+    }
+    const uint8_t* p = page.contents();
+    int32_t result = 0;
+    result |= static_cast<int32_t>(p[offset + 0]) << 24;
+    result |= static_cast<int32_t>(p[offset + 1]) << 16;
+    result |= static_cast<int32_t>(p[offset + 2]) << 8;
+    result |= static_cast<int32_t>(p[offset + 3]) << 0;
+    return result;
+}
+
+volatile int64_t sink;
+
+template <typename Read>
+void run(const std::string& label, const Page& page, size_t reads, Read read) {
+    const size_t fields = BLOCK_SIZE / FIELD_STRIDE;
+    size_t passes = (reads + fields - 1) / fields;
+    int64_t acc = 0;
+    bench::Timer t;
+    for (size_t p = 0; p < passes; p++) {
+        for (size_t off = 0; off + 4 <= BLOCK_SIZE; off += FIELD_STRIDE) {
+            acc += read(page, off);
+        }
+    }
+    bench::report(label, passes * fields, t.elapsed_ns());
+    sink = acc;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t millions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50;
+    size_t reads = millions * 1000000;
+
+    Page be(BLOCK_SIZE, ByteOrder::BigEndian);
+    Page le(BLOCK_SIZE, ByteOrder::LittleEndian);
+    for (size_t off = 0; off + 4 <= BLOCK_SIZE; off += FIELD_STRIDE) {
+        be.set_int(off, static_cast<int32_t>(off * 7));
+        le.set_int(off, static_cast<int32_t>(off * 7));
+    }
+
+    std::printf("%zu int reads over a %zu-byte page\n", reads, BLOCK_SIZE);
+
+    run("legacy byte-wise big-endian", be, reads,
+        [](const Page& p, size_t off) { return legacy_get_int(p, off); });
+    run("get_int big-endian (bswap)", be, reads,
+        [](const Page& p, size_t off) { return p.get_int(off); });
+    run("get_int little-endian", le, reads,
+        [](const Page& p, size_t off) { return p.get_int(off); });
+    run("get_int_unchecked little-endian", le, reads,
+        [](const Page& p, size_t off) { return p.get_int_unchecked(off); });
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Pin/unpin throughput of BufferMgr as the pool grows.
+//
+// For each pool size, every frame is first filled with a distinct block;
+// then random resident blocks are pinned and unpinned, so every pin is a
+// page-table hit. With the hash-indexed page table the cost per pin should
+// stay flat from 8 to 1M frames. The "linear" column replays the old
+// lookup (a scan over every frame comparing BlockIds) on the same data
+// for pools up to 64K frames, beyond which it is too slow to be useful.
+//
+// Blocks are never written to disk: pinning a block past the end of the
+// file leaves the page as is, which keeps the run free of I/O.
+//
+// Usage: bench_pin [max_frames] [pins_per_size]
+
+#include "bench_util.hpp"
+#include "buffer/buffermgr.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <vector>
+
+using file::BlockId;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 64;  // small pages so 1M frames fit in memory
+constexpr size_t MAX_LINEAR_FRAMES = 1 << 16;
+
+volatile size_t sink;
+
+// <random> cannot be used next to the log namespace (it clashes with ::log
+// from <cmath>), so probes come from a small xorshift generator
+uint64_t next_random(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t max_frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (1 << 20);
+    size_t pins = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+
+    bench::ScratchDir dir("pin");
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE);
+    auto lm = std::make_shared<log::LogMgr>(fm, "bench.log");
+    const file::FileId file = fm->file_id("pinned.tbl");
+
+    std::printf("%zu random pins per pool size\n", pins);
+    std::printf("%-10s %14s %14s\n", "frames", "hashed ns/pin", "linear ns/pin");
+
+    for (size_t frames = 8; frames <= max_frames; frames *= 2) {
+        buffer::BufferMgr bm(fm, lm, frames);
+        for (size_t i = 0; i < frames; i++) {
+            bm.unpin(bm.pin(BlockId(file, static_cast<int32_t>(i))));
+        }
+
+        uint64_t rng = 42;
+        std::vector<int32_t> probes(pins);
+        for (auto& p : probes) p = static_cast<int32_t>(next_random(rng) % frames);
+
+        bench::Timer t;
+        for (int32_t b : probes) {
+            bm.unpin(bm.pin(BlockId(file, b)));
+        }
+        double hashed = t.elapsed_ns() / static_cast<double>(pins);
+
+        double linear = 0;
+        if (frames <= MAX_LINEAR_FRAMES) {
+            std::vector<std::optional<BlockId>> blocks;
+            for (size_t i = 0; i < frames; i++) blocks.push_back(bm.buffer(i).block());
+            size_t acc = 0;
+            size_t linear_pins = std::min(pins, size_t(20000));
+            t.reset();
+            for (size_t k = 0; k < linear_pins; k++) {
+                BlockId blk(file, probes[k]);
+                for (size_t i = 0; i < blocks.size(); i++) {
+                    if (blocks[i].has_value() && blocks[i].value() == blk) {
+                        acc += i;
+                        break;
+                    }
+                }
+            }
+            linear = t.elapsed_ns() / static_cast<double>(linear_pins);
+            sink = acc;
+        }
+
+        if (linear > 0) {
+            std::printf("%-10zu %14.1f %14.1f\n", frames, hashed, linear);
+        } else {
+            std::printf("%-10zu %14.1f %14s\n", frames, hashed, "-");
+        }
+    }
+    return 0;
+}
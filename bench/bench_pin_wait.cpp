@@ -0,0 +1,99 @@
+// Pin latency when the buffer pool is oversubscribed.
+//
+// More threads than frames each pin a new block, hold it for a short
+// while and unpin it, so every pin needs a free buffer and most have to
+// wait for one. The
+// "queued" rows use BufferMgr's FIFO wait queue. The "polling" rows
+// replay the old behaviour on top of it: try with a zero timeout and, on
+// BufferAbortException, sleep 100 ms and retry. Latencies are per pin,
+// from the first attempt until the buffer is obtained. Polling lets a
+// thread that just unpinned take the buffer straight back, so most of its
+// pins are fast while the unlucky ones stall for 100 ms or more; compare
+// the max and total columns.
+//
+// Usage: bench_pin_wait [threads] [frames] [pins_per_thread] [hold_us]
+
+#include "bench_util.hpp"
+#include "buffer/buffermgr.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using file::BlockId;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+
+void run(std::shared_ptr<file::FileMgr> fm, std::shared_ptr<log::LogMgr> lm,
+         file::FileId file, size_t nthreads, size_t frames, size_t pins, size_t hold_us,
+         bool polling, const char* label) {
+    buffer::BufferMgr bm(fm, lm, frames);
+    if (polling) {
+        bm.set_max_time(0);
+    }
+
+    std::vector<std::vector<double>> latencies(nthreads);
+    bench::Timer total;
+    std::vector<std::thread> threads;
+    for (size_t th = 0; th < nthreads; th++) {
+        threads.emplace_back([&, th] {
+            for (size_t i = 0; i < pins; i++) {
+                BlockId blk(file, static_cast<int32_t>(th * pins + i));
+                bench::Timer t;
+                size_t idx;
+                while (true) {
+                    try {
+                        idx = bm.pin(blk);
+                        break;
+                    } catch (const buffer::BufferAbortException&) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    }
+                }
+                latencies[th].push_back(t.elapsed_ns() / 1000.0);
+                std::this_thread::sleep_for(std::chrono::microseconds(hold_us));
+                bm.unpin(idx);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    double elapsed_ms = total.elapsed_ns() / 1e6;
+
+    std::vector<double> all;
+    for (const auto& v : latencies) all.insert(all.end(), v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    auto pct = [&](double p) { return all[static_cast<size_t>(p * static_cast<double>(all.size() - 1))]; };
+    std::printf("%-10s %10.1f %10.1f %10.1f %12.1f\n", label, pct(0.5), pct(0.99), all.back(),
+                elapsed_ms);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t nthreads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+    size_t frames = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    size_t pins = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 200;
+    size_t hold_us = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 200;
+
+    bench::ScratchDir dir("pin_wait");
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE);
+    auto lm = std::make_shared<log::LogMgr>(fm, "bench.log");
+    file::Page page(BLOCK_SIZE);
+    for (size_t i = 0; i < nthreads * pins; i++) {
+        fm->write(fm->append("wait.tbl"), page);
+    }
+    const file::FileId file = fm->file_id("wait.tbl");
+
+    std::printf("%zu threads, %zu frames, %zu pins per thread, %zu us hold\n", nthreads, frames,
+                pins, hold_us);
+    std::printf("%-10s %10s %10s %10s %12s\n", "waiting", "p50 us", "p99 us", "max us",
+                "total ms");
+    run(fm, lm, file, nthreads, frames, pins, hold_us, false, "queued");
+    run(fm, lm, file, nthreads, frames, pins, hold_us, true, "polling");
+    return 0;
+}
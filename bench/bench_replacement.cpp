@@ -0,0 +1,94 @@
+// Hit ratio and pin latency of each buffer replacement policy on
+// synthetic traces.
+//
+// A file of nblocks blocks is written once; each trace is then replayed
+// against a fresh BufferMgr per policy, pinning and immediately unpinning
+// every block in the trace. Misses read the block from the file (usually
+// from the OS page cache), so the latency column includes that read.
+//
+// Traces:
+//   zipf       Zipfian over the whole file (theta 0.99)
+//   zipf+scan  the same, with 1 in 5000 accesses starting a sequential scan of
+//              twice the pool size (roughly 30% of the trace is scans)
+//
+// Usage: bench_replacement [nblocks] [pool_frames] [trace_length]
+
+#include "bench_util.hpp"
+#include "workload.hpp"
+#include "buffer/buffermgr.hpp"
+#include "buffer/replacementpolicy.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using buffer::ReplacementKind;
+using file::BlockId;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+constexpr double THETA = 0.99;
+
+const char* policy_name(ReplacementKind kind) {
+    switch (kind) {
+        case ReplacementKind::Clock: return "clock";
+        case ReplacementKind::LruK: return "lru-2";
+        case ReplacementKind::TwoQ: return "2q";
+        default: return "naive";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t nblocks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16384;
+    size_t frames = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1024;
+    size_t length = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 500000;
+
+    bench::ScratchDir dir("replacement");
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE);
+    auto lm = std::make_shared<log::LogMgr>(fm, "bench.log");
+    const std::string filename = "trace.tbl";
+    file::Page page(BLOCK_SIZE);
+    for (size_t i = 0; i < nblocks; i++) {
+        fm->write(fm->append(filename), page);
+    }
+    const file::FileId file = fm->file_id(filename);
+
+    struct Trace {
+        const char* name;
+        std::vector<int32_t> blocks;
+    };
+    std::vector<Trace> traces = {
+        {"zipf", bench::zipf_trace(nblocks, length, THETA, 1)},
+        {"zipf+scan", bench::scan_mixed_trace(nblocks, length, THETA, 0.0002, 2 * frames, 2)},
+    };
+
+    std::printf("%zu blocks of %zu bytes, %zu frames, %zu accesses per trace\n",
+                nblocks, BLOCK_SIZE, frames, length);
+    std::printf("%-10s %-8s %10s %12s\n", "trace", "policy", "hit ratio", "ns/pin");
+
+    for (const Trace& trace : traces) {
+        for (ReplacementKind kind : {ReplacementKind::Naive, ReplacementKind::Clock,
+                                     ReplacementKind::LruK, ReplacementKind::TwoQ}) {
+            buffer::BufferMgrOptions options;
+            options.policy = kind;
+            buffer::BufferMgr bm(fm, lm, frames, options);
+            bench::Timer t;
+            for (int32_t b : trace.blocks) {
+                bm.unpin(bm.pin(BlockId(file, b)));
+            }
+            double ns = t.elapsed_ns() / static_cast<double>(trace.blocks.size());
+
+            buffer::BufferStats stats = bm.stats();
+            double ratio = static_cast<double>(stats.hits) /
+                           static_cast<double>(stats.hits + stats.misses);
+            std::printf("%-10s %-8s %9.1f%% %12.1f\n", trace.name, policy_name(kind),
+                        100.0 * ratio, ns);
+        }
+    }
+    return 0;
+}
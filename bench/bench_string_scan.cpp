@@ -0,0 +1,92 @@
+// String predicate cost in a TableScan: copying vs string_view access.
+//
+// Scans a table of (id, name) rows and counts rows whose name equals a
+// constant, the way a selection on a VARCHAR column would:
+//   - copy: Constant(scan.get_val(name)) == constant   (string copies per row)
+//   - view: constant == scan.get_string_view(name)     (no copies)
+// Heap allocations are counted by replacing the global operator new, and
+// reported per row next to the timing.
+//
+// Usage: bench_string_scan [num_rows] [passes]
+
+#include "bench_util.hpp"
+#include "buffer/buffermgr.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include "record/layout.hpp"
+#include "record/schema.hpp"
+#include "record/tablescan.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+
+constexpr size_t BLOCK_SIZE = 4096;
+constexpr size_t POOL_SIZE = 64;
+
+} // namespace
+
+void* operator new(size_t n) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main(int argc, char** argv) {
+    size_t num_rows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    size_t passes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+
+    bench::ScratchDir dir("string_scan");
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE);
+    auto lm = std::make_shared<log::LogMgr>(fm, "bench.log");
+    auto bm = std::make_shared<buffer::BufferMgr>(fm, lm, POOL_SIZE);
+
+    auto schema = std::make_shared<record::Schema>();
+    schema->add_int_field("id");
+    schema->add_string_field("name", 32);
+    record::Layout layout(schema);
+
+    {
+        record::TableScan scan(bm, "people", layout);
+        for (size_t i = 0; i < num_rows; i++) {
+            scan.insert();
+            scan.set_int("id", static_cast<int32_t>(i));
+            // Longer than the small-string buffer, as most VARCHAR values are
+            scan.set_string("name", "customer-name-number-" + std::to_string(i % 1000));
+        }
+        scan.close();
+    }
+
+    const Constant target = Constant::with_string("customer-name-number-500");
+    std::printf("%zu rows, %zu passes\n", num_rows, passes);
+
+    for (bool use_view : {false, true}) {
+        size_t matches = 0;
+        size_t rows = 0;
+        size_t allocs_before = allocations.load();
+        bench::Timer t;
+        for (size_t p = 0; p < passes; p++) {
+            record::TableScan scan(bm, "people", layout);
+            while (scan.next()) {
+                bool hit = use_view ? target == scan.get_string_view("name")
+                                    : scan.get_val("name") == target;
+                matches += hit ? 1 : 0;
+                rows++;
+            }
+            scan.close();
+        }
+        double ns = t.elapsed_ns();
+        size_t allocs = allocations.load() - allocs_before;
+        bench::report(use_view ? "view predicate" : "copy predicate", rows, ns);
+        std::printf("    %.2f allocations/row, %zu matches\n",
+                    rows ? static_cast<double>(allocs) / static_cast<double>(rows) : 0.0, matches);
+    }
+    return 0;
+}
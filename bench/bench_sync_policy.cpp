@@ -0,0 +1,67 @@
+// Write throughput under each FileMgr durability policy.
+//
+// Writes num_blocks random blocks of a data file:
+//   - None:       never synced
+//   - Deferred:   one sync() per batch of batch_size writes (what
+//                 BufferMgr::flush_all does at commit/checkpoint)
+//   - EveryWrite: fdatasync inside every write
+//
+// Usage: bench_sync_policy [num_blocks] [batch_size]
+
+#include "bench_util.hpp"
+#include "file/filemgr.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using file::BlockId;
+using file::FileMgr;
+using file::FileMgrOptions;
+using file::Page;
+using file::SyncPolicy;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t num_blocks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2048;
+    size_t batch = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+    if (batch == 0) batch = 1;
+
+    std::vector<int32_t> order(num_blocks);
+    for (size_t i = 0; i < num_blocks; i++) order[i] = static_cast<int32_t>(i);
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    std::printf("block size %zu, %zu blocks, deferred batch %zu\n", BLOCK_SIZE, num_blocks, batch);
+
+    const std::pair<const char*, SyncPolicy> policies[] = {
+        {"None", SyncPolicy::None},
+        {"Deferred", SyncPolicy::Deferred},
+        {"EveryWrite", SyncPolicy::EveryWrite},
+    };
+    for (const auto& [name, policy] : policies) {
+        bench::ScratchDir dir("sync_policy");
+        FileMgrOptions options;
+        options.data_sync = policy;
+        FileMgr fm(dir.path(), BLOCK_SIZE, options);
+        for (size_t i = 0; i < num_blocks; i++) fm.append("data.tbl");
+        fm.sync_all();
+        size_t syncs_before = fm.sync_count();
+
+        Page page(BLOCK_SIZE);
+        bench::Timer t;
+        for (size_t i = 0; i < num_blocks; i++) {
+            page.set_int(0, static_cast<int32_t>(i));
+            fm.write(BlockId("data.tbl", order[i]), page);
+            if ((i + 1) % batch == 0) fm.sync("data.tbl");
+        }
+        fm.sync("data.tbl");
+        bench::report(std::string(name) + " write", num_blocks, t.elapsed_ns());
+        std::printf("    %zu fdatasync calls\n", fm.sync_count() - syncs_before);
+    }
+    return 0;
+}
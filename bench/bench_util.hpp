@@ -0,0 +1,61 @@
+#ifndef BENCH_UTIL_HPP
+#define BENCH_UTIL_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+namespace bench {
+
+/**
+ * Simple wall-clock stopwatch used by the microbenchmarks.
+ */
+class Timer {
+public:
+    Timer() : start_(std::chrono::steady_clock::now()) {}
+
+    void reset() { start_ = std::chrono::steady_clock::now(); }
+
+    double elapsed_ns() const {
+        auto d = std::chrono::steady_clock::now() - start_;
+        return static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * Creates an empty scratch directory for a benchmark run and removes it
+ * again when the object goes out of scope.
+ */
+class ScratchDir {
+public:
+    explicit ScratchDir(const std::string& name)
+        : path_("/tmp/mudopdb_bench_" + name) {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+
+    ~ScratchDir() { std::filesystem::remove_all(path_); }
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+/**
+ * Prints one result line in a fixed format: label, operation count and
+ * average nanoseconds per operation.
+ */
+inline void report(const std::string& label, size_t ops, double total_ns) {
+    std::printf("%-40s %10zu ops %12.1f ns/op\n",
+                label.c_str(), ops, ops ? total_ns / static_cast<double>(ops) : 0.0);
+}
+
+} // namespace bench
+
+#endif // BENCH_UTIL_HPP
@@ -0,0 +1,110 @@
+// Buffer pool warm restart: pins right after startup, cold and warm.
+//
+// A first BufferMgr runs a skewed random workload until its pool holds
+// the hot set, and saves its resident set on destruction. The workload is
+// then replayed against a new pool twice: once cold, and once with
+// warm_file set, so that a background thread reloads the saved set while
+// the pins run. Each row reports how long the constructor took, the hit
+// rate and pin latency over the first pins, and when the reload finished.
+// The OS page cache is not dropped, so misses are cheaper here than after
+// a real restart.
+//
+// Usage: bench_warm_restart [pins]
+
+#include "bench_util.hpp"
+#include "buffer/buffermgr.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using file::BlockId;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 4096;
+constexpr size_t NUM_BLOCKS = 65536;
+constexpr size_t POOL_FRAMES = 16384;
+
+uint64_t next_random(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// 90% of pins go to the first POOL_FRAMES / 2 blocks
+int32_t skewed_block(uint64_t& rng) {
+    uint64_t r = next_random(rng);
+    size_t range = r % 10 < 9 ? POOL_FRAMES / 2 : NUM_BLOCKS;
+    return static_cast<int32_t>((r >> 8) % range);
+}
+
+void run(std::shared_ptr<file::FileMgr> fm, std::shared_ptr<log::LogMgr> lm, file::FileId file,
+         const buffer::BufferMgrOptions& options, size_t pins, const char* label) {
+    bench::Timer startup;
+    buffer::BufferMgr bm(fm, lm, POOL_FRAMES, options);
+    double startup_ms = startup.elapsed_ns() / 1e6;
+
+    std::vector<double> latencies;
+    latencies.reserve(pins);
+    uint64_t rng = 5;
+    bench::Timer total;
+    for (size_t i = 0; i < pins; i++) {
+        int32_t b = skewed_block(rng);
+        bench::Timer t;
+        bm.unpin(bm.pin(BlockId(file, b)));
+        latencies.push_back(t.elapsed_ns() / 1000.0);
+    }
+    double pins_ms = total.elapsed_ns() / 1e6;
+    bm.wait_for_restore();
+    double restored_ms = total.elapsed_ns() / 1e6;
+
+    buffer::BufferStats stats = bm.stats();
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("%-6s %12.2f %9.1f%% %10.2f %10.2f %12.1f %12.1f %10zu\n", label, startup_ms,
+                100.0 * static_cast<double>(stats.hits) / static_cast<double>(pins),
+                latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100],
+                pins_ms, options.warm_file.empty() ? 0.0 : restored_ms, stats.restored);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t pins = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+
+    bench::ScratchDir dir("warm_restart");
+    auto fm = std::make_shared<file::FileMgr>(dir.path(), BLOCK_SIZE);
+    auto lm = std::make_shared<log::LogMgr>(fm, "bench.log");
+    file::Page page(BLOCK_SIZE);
+    for (size_t i = 0; i < NUM_BLOCKS; i++) {
+        fm->write(fm->append("data.tbl"), page);
+    }
+    const file::FileId file = fm->file_id("data.tbl");
+
+    buffer::BufferMgrOptions warm;
+    warm.policy = buffer::ReplacementKind::Clock;
+    warm.partitions = 8;
+    warm.warm_file = dir.path() + "/pool.warm";
+    {
+        // Earlier run: fill the pool with the hot set, saved on destruction
+        buffer::BufferMgr bm(fm, lm, POOL_FRAMES, warm);
+        uint64_t rng = 1;
+        for (size_t i = 0; i < POOL_FRAMES * 8; i++) {
+            bm.unpin(bm.pin(BlockId(file, skewed_block(rng))));
+        }
+    }
+
+    std::printf("%zu frames, %zu blocks, first %zu pins after startup\n", POOL_FRAMES,
+                NUM_BLOCKS, pins);
+    std::printf("%-6s %12s %10s %10s %10s %12s %12s %10s\n", "start", "startup ms", "hit rate",
+                "p50 us", "p99 us", "pins ms", "reloaded ms", "reloaded");
+    buffer::BufferMgrOptions cold = warm;
+    cold.warm_file.clear();
+    run(fm, lm, file, cold, pins, "cold");
+    run(fm, lm, file, warm, pins, "warm");
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "workload.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace bench {
+
+namespace {
+
+/**
+ * Samples ranks by binary search over a precomputed CDF and maps each rank
+ * to a block through a random permutation.
+ */
+class ZipfSampler {
+public:
+    ZipfSampler(size_t n, double theta, std::mt19937_64& rng)
+        : cdf_(n), blocks_(n) {
+        double sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+            cdf_[i] = sum;
+        }
+        for (double& c : cdf_) c /= sum;
+        std::iota(blocks_.begin(), blocks_.end(), 0);
+        std::shuffle(blocks_.begin(), blocks_.end(), rng);
+    }
+
+    int32_t next(std::mt19937_64& rng) {
+        double u = uniform_(rng);
+        size_t rank = static_cast<size_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) -
+                                          cdf_.begin());
+        return blocks_[std::min(rank, blocks_.size() - 1)];
+    }
+
+private:
+    std::vector<double> cdf_;
+    std::vector<int32_t> blocks_;
+    std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+};
+
+} // namespace
+
+std::vector<int32_t> zipf_trace(size_t nblocks, size_t length, double theta, uint64_t seed) {
+    return scan_mixed_trace(nblocks, length, theta, 0.0, 0, seed);
+}
+
+std::vector<int32_t> scan_mixed_trace(size_t nblocks, size_t length, double theta,
+                                      double scan_prob, size_t scan_len, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    ZipfSampler zipf(nblocks, theta, rng);
+    std::bernoulli_distribution starts_scan(scan_prob);
+    std::uniform_int_distribution<size_t> scan_start(0, nblocks - 1);
+
+    std::vector<int32_t> trace;
+    trace.reserve(length);
+    while (trace.size() < length) {
+        if (scan_len > 0 && starts_scan(rng)) {
+            size_t start = scan_start(rng);
+            for (size_t i = 0; i < scan_len && trace.size() < length; i++) {
+                trace.push_back(static_cast<int32_t>((start + i) % nblocks));
+            }
+        } else {
+            trace.push_back(zipf.next(rng));
+        }
+    }
+    return trace;
+}
+
+} // namespace bench
@@ -0,0 +1,42 @@
+#ifndef BENCH_WORKLOAD_HPP
+#define BENCH_WORKLOAD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bench {
+
+/**
+ * Generates a trace of block numbers in [0, nblocks) drawn from a Zipfian
+ * distribution with the given skew. Popular blocks are spread over the
+ * file rather than clustered at its start.
+ *
+ * Lives in its own translation unit because <random> and <cmath> cannot
+ * be included next to the log namespace.
+ *
+ * @param nblocks the number of distinct blocks
+ * @param length the number of accesses
+ * @param theta the skew; 0 is uniform, ~1 is highly skewed
+ * @param seed the random seed
+ */
+std::vector<int32_t> zipf_trace(size_t nblocks, size_t length, double theta, uint64_t seed);
+
+/**
+ * Generates a Zipfian trace interrupted by sequential scans: each access
+ * starts a scan with probability scan_prob, and a scan reads scan_len
+ * consecutive blocks from a random starting point.
+ *
+ * @param nblocks the number of distinct blocks
+ * @param length the number of accesses
+ * @param theta the skew of the non-scan accesses
+ * @param scan_prob the chance that an access starts a scan
+ * @param scan_len the number of blocks per scan
+ * @param seed the random seed
+ */
+std::vector<int32_t> scan_mixed_trace(size_t nblocks, size_t length, double theta,
+                                      double scan_prob, size_t scan_len, uint64_t seed);
+
+} // namespace bench
+
+#endif // BENCH_WORKLOAD_HPP
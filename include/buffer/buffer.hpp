@@ -5,12 +5,16 @@
 #include "file/blockid.hpp"
 #include "file/filemgr.hpp"
 #include "log/logmgr.hpp"
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <cstdint>
+#include <thread>
 
 namespace buffer {
 
+class BufferMgr;
+
 /**
  * Buffer wraps a Page with pinning and modification tracking.
  *
@@ -27,10 +31,22 @@ namespace buffer {
  * 1. Flush log first (if lsn is set)
  * 2. Then flush data page to disk
  *
+ * A buffer in a BufferMgr pool reports each transaction that starts
+ * modifying it to the manager, which keeps per-transaction dirty lists.
+ *
  * Corresponds to Buffer in Rust (NMDB2/src/buffer/buffer.rs)
  *
- * Thread Safety: This class is NOT thread-safe. External synchronization
- * is required if used in multi-threaded context.
+ * Frame latch: the page contents of a pinned buffer are guarded by a
+ * version counter (optimistic lock coupling). A writer holds the latch
+ * exclusively, which makes the version odd, and releases it with a new
+ * even version. A reader takes no latch: read_optimistic() notes the
+ * version, reads, and retries if the version changed in between, so
+ * readers never block one another or write to shared memory.
+ *
+ * Thread Safety: the pin count and frame version are atomic, so
+ * is_pinned() and the latch may be used from any thread. Everything else
+ * is guarded by the BufferMgr partition that owns the buffer, or belongs
+ * to the transactions pinning it.
  */
 class Buffer {
 public:
@@ -43,6 +59,18 @@ public:
     Buffer(std::shared_ptr<file::FileMgr> fm,
            std::shared_ptr<log::LogMgr> lm);
 
+    /**
+     * Creates a buffer whose page uses the given storage, e.g. a frame of
+     * a FrameArena.
+     *
+     * @param fm the file manager
+     * @param lm the log manager
+     * @param frame block_size() writable bytes that outlive the buffer
+     */
+    Buffer(std::shared_ptr<file::FileMgr> fm,
+           std::shared_ptr<log::LogMgr> lm,
+           uint8_t* frame);
+
     /**
      * Returns a reference to the buffer's page contents.
      * Allows reading and writing to the page.
@@ -60,7 +88,9 @@ public:
 
     /**
      * Marks the buffer as modified by the specified transaction.
-     * If lsn is provided, it updates the buffer's LSN.
+     * If lsn is provided, it updates the buffer's LSN. If the buffer was
+     * not already modified by txnum, its BufferMgr (if any) adds it to
+     * the transaction's dirty list.
      *
      * @param txnum the modifying transaction number
      * @param lsn the log sequence number (optional)
@@ -81,6 +111,78 @@ public:
      */
     std::optional<size_t> modifying_tx() const;
 
+    /**
+     * Returns how many times set_modified() has been called, so that a
+     * writer can tell whether the page was modified after it copied it.
+     *
+     * @return the number of modifications
+     */
+    uint64_t modification_count() const;
+
+    /**
+     * Runs a read of the page contents without latching and returns its
+     * result, retrying until no writer held or took the frame latch
+     * meanwhile. fn may see a page that is being modified: it must only
+     * read, must copy out what it returns, and may throw (the exception
+     * is only passed on if the read was consistent).
+     *
+     * @param fn the read, called one or more times
+     * @return the result of the first consistent call
+     */
+    template <typename Fn>
+    auto read_optimistic(Fn&& fn) const -> decltype(fn()) {
+        while (true) {
+            uint64_t version = read_version();
+            try {
+                auto result = fn();
+                if (validate(version)) {
+                    return result;
+                }
+            } catch (...) {
+                if (validate(version)) {
+                    throw;
+                }
+            }
+        }
+    }
+
+    /**
+     * Waits until no writer holds the frame latch and returns the
+     * current (even) version, to be checked by validate().
+     */
+    uint64_t read_version() const {
+        for (int spins = 0;; spins++) {
+            uint64_t v = version_.load(std::memory_order_acquire);
+            if ((v & 1) == 0) {
+                return v;
+            }
+            if (spins >= 64) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * Returns true if no writer has taken the frame latch since
+     * read_version() returned version, i.e. the reads made since then
+     * saw a consistent page.
+     */
+    bool validate(uint64_t version) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version_.load(std::memory_order_relaxed) == version;
+    }
+
+    /**
+     * Takes the frame latch exclusively, waiting for another writer to
+     * release it. Not reentrant.
+     */
+    void latch_exclusive();
+
+    /**
+     * Releases the frame latch and publishes the page under a new version.
+     */
+    void unlatch_exclusive();
+
     /**
      * Assigns this buffer to a block.
      * Flushes the previous block if dirty, then reads the new block.
@@ -92,6 +194,17 @@ public:
      */
     void assign_to_block(const file::BlockId& blk);
 
+    /**
+     * Assigns this buffer to a block whose contents the caller loads
+     * itself, e.g. as part of a multi-block read. Flushes the previous
+     * block if dirty and resets pins to 0, but does not read.
+     *
+     * NOTE: Package-private - should only be called by BufferMgr
+     *
+     * @param blk the block to assign
+     */
+    void assign_to_block_unread(const file::BlockId& blk);
+
     /**
      * Flushes the buffer to disk if it has been modified.
      * Follows WAL: flushes log first if lsn is set.
@@ -101,6 +214,44 @@ public:
      */
     void flush();
 
+    /**
+     * Returns the log sequence number of the latest logged modification.
+     *
+     * @return the LSN, or std::nullopt if none was logged
+     */
+    std::optional<size_t> modifying_lsn() const;
+
+    /**
+     * Starts an asynchronous write of the buffer if it has been modified.
+     * The page is copied into copy under the frame latch and the copy is
+     * written, so pinners may keep modifying the frame meanwhile. Unlike
+     * flush(), it does not flush the log: the caller must already have
+     * flushed it up to modifying_lsn(). The buffer stays modified until
+     * finish_flush() is called once the write has completed.
+     *
+     * NOTE: Package-private - should only be called by BufferMgr
+     *
+     * @param copy receives the page; must outlive the write
+     * @return a handle to wait on; already done if there was nothing to write
+     */
+    file::IoHandle flush_async(file::Page& copy);
+
+    /**
+     * Marks the buffer as clean after a write started by flush_async()
+     * has completed.
+     *
+     * NOTE: Package-private - should only be called by BufferMgr
+     */
+    void finish_flush();
+
+    /**
+     * Registers the buffer as frame idx of a BufferMgr pool, which is
+     * told about every transaction that starts modifying it.
+     *
+     * NOTE: Package-private - should only be called by BufferMgr
+     */
+    void attach(BufferMgr* owner, size_t idx);
+
     /**
      * Increments the pin count.
      *
@@ -120,9 +271,28 @@ private:
     std::shared_ptr<log::LogMgr> lm_;
     file::Page contents_;
     std::optional<file::BlockId> blk_;
-    int32_t pins_;
+    std::atomic<int32_t> pins_;
+    std::atomic<uint64_t> version_{0};  // frame latch; odd while a writer holds it
     std::optional<size_t> txnum_;
     std::optional<size_t> lsn_;
+    std::atomic<uint64_t> modifications_{0};  // calls to set_modified()
+    BufferMgr* owner_ = nullptr;  // the pool this buffer belongs to, if any
+    size_t index_ = 0;            // frame index in owner_'s pool
+};
+
+/**
+ * Holds a buffer's exclusive frame latch for its lifetime.
+ */
+class FrameWriteLatch {
+public:
+    explicit FrameWriteLatch(Buffer& buff) : buff_(buff) { buff_.latch_exclusive(); }
+    ~FrameWriteLatch() { buff_.unlatch_exclusive(); }
+
+    FrameWriteLatch(const FrameWriteLatch&) = delete;
+    FrameWriteLatch& operator=(const FrameWriteLatch&) = delete;
+
+private:
+    Buffer& buff_;
 };
 
 } // namespace buffer
@@ -2,15 +2,27 @@
 #define BUFFERMGR_HPP
 
 #include "buffer/buffer.hpp"
+#include "buffer/framearena.hpp"
+#include "buffer/replacementpolicy.hpp"
 #include "file/blockid.hpp"
 #include "file/filemgr.hpp"
 #include "log/logmgr.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <optional>
 #include <chrono>
 #include <thread>
 #include <stdexcept>
+#include <string>
 
 namespace buffer {
 
@@ -23,6 +35,80 @@ public:
         : std::runtime_error("Buffer abort: pool exhausted after timeout") {}
 };
 
+/**
+ * Counters describing how pin() requests were served and how dirty
+ * pages reached the disk.
+ */
+struct BufferStats {
+    size_t hits = 0;               // pins of blocks that were already resident
+    size_t misses = 0;             // pins that had to assign a buffer to the block
+    size_t waits = 0;              // pins that queued because the partition was full
+    size_t clean_evictions = 0;    // buffer reassignments that replaced a clean page
+    size_t dirty_evictions = 0;    // reassignments that first had to write the old page
+    size_t background_writes = 0;  // pages written by the background writer
+    size_t ring_reuses = 0;        // misses served by recycling a BufferRing frame
+    size_t prefetches = 0;         // blocks read ahead by prefetch() or readahead
+    size_t prefetch_hits = 0;      // pins that found a prefetched block
+    size_t commit_writes = 0;      // pages written by flush_all()
+    size_t restored = 0;           // blocks reloaded from a saved resident set
+};
+
+/**
+ * Construction-time settings for BufferMgr.
+ */
+struct BufferMgrOptions {
+    ReplacementKind policy = ReplacementKind::Naive;  // victim selection in each partition
+    size_t partitions = 1;                            // independently latched pool slices
+    bool background_writer = false;   // trickle unpinned dirty pages to disk
+    size_t writer_batch = 64;         // most pages written per writer round
+    uint64_t writer_interval_ms = 20; // pause between writer rounds
+    size_t readahead_max = 0;         // largest sequential readahead window, in blocks; 0 = off
+    FrameMemory frame_memory = FrameMemory::Arena;  // where the frames' page bytes live
+    std::string warm_file;               // resident set saved for warm restarts; empty = off
+    uint64_t warm_save_interval_ms = 0;  // also save it this often; 0 = only on destruction
+};
+
+/**
+ * A private set of buffers that one large sequential scan recycles, so
+ * that it does not displace the rest of the pool (a buffer access
+ * strategy). Pass it to BufferMgr::pin() and load_range().
+ *
+ * On a miss, the ring hands back its oldest buffer if that buffer still
+ * holds the block the ring put there and nobody has it pinned; otherwise
+ * the buffer is dropped from the ring and a victim is taken from the
+ * replacement policy, which the ring keeps while it has room. Buffers
+ * stay part of the shared pool throughout and may be evicted normally.
+ *
+ * The capacity is split evenly across the pool's partitions, with at
+ * least one buffer each. A ring belongs to a single scan and must not be
+ * used by two threads at once, nor with more than one BufferMgr.
+ */
+class BufferRing {
+public:
+    /**
+     * Creates an empty ring.
+     *
+     * @param capacity the number of buffers the ring may own
+     */
+    explicit BufferRing(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+    /**
+     * Returns the number of buffers the ring may own.
+     */
+    size_t capacity() const { return capacity_; }
+
+private:
+    friend class BufferMgr;
+
+    struct Slot {
+        size_t frame;
+        file::BlockId blk;  // the block the ring last placed in the frame
+    };
+
+    size_t capacity_;
+    std::vector<std::deque<Slot>> slots_;  // per partition, oldest first
+};
+
 /**
  * BufferMgr manages a fixed-size pool of buffers.
  *
@@ -31,18 +117,96 @@ public:
  * - unpin(idx) decrements pin count, makes buffer available
  * - Buffers with pins > 0 cannot be evicted
  *
+ * Partitions:
+ * - The pool is split into BufferMgrOptions::partitions contiguous slices
+ *   of buffer indices. A block always lives in the partition its hash
+ *   selects, so a pin only ever touches that partition.
+ * - Each partition has its own latch, page table (BlockId -> buffer
+ *   index), replacement policy and available count; there is no global
+ *   lock on the pin/unpin path.
+ *
+ * Frame memory:
+ * - By default the page bytes of all buffers are views into one
+ *   contiguous FrameArena, optionally backed by huge pages
+ *   (BufferMgrOptions::frame_memory). FrameMemory::Heap gives each page
+ *   its own allocation instead.
+ *
  * Eviction Policy:
- * - Simple: first unpinned buffer found (naive strategy)
- * - Can be upgraded to clock algorithm or LRU later
+ * - Chosen at construction (ReplacementKind); Naive by default, which
+ *   reuses the first unpinned buffer by index. See ReplacementPolicy.
+ *   The policy only chooses among the buffers of one partition.
  *
- * When pool is full:
- * - pin() waits up to MAX_TIME milliseconds
+ * When a block's partition is full:
+ * - pin() joins the partition's FIFO wait queue for up to MAX_TIME
+ *   milliseconds; each unpin() that frees a buffer wakes the oldest waiter
+ * - While anyone is queued, a new pin() that would need a free buffer
+ *   queues behind them instead of taking it; pins of resident blocks
+ *   are still served at once
  * - Throws BufferAbortException if timeout expires
  *
+ * Background writer (BufferMgrOptions::background_writer):
+ * - A thread sweeps the pool round-robin every writer_interval_ms and
+ *   writes up to writer_batch unpinned dirty pages, so that evictions
+ *   mostly find clean victims. The log is flushed up to the pages' LSNs
+ *   first, as for any other write.
+ * - As in flush_all(), the pages are only chosen under the partition
+ *   latches. The writer pins each one, so it is not evicted meanwhile,
+ *   and writes a copy of it in one batch without the latches. A page
+ *   modified after it was copied stays dirty.
+ *
+ * Scans:
+ * - A BufferRing passed to pin()/load_range()/prefetch() confines the
+ *   misses of a large sequential scan to a few recycled buffers. See
+ *   BufferRing.
+ * - prefetch() assigns buffers to blocks and starts asynchronous reads
+ *   (FileMgr::read_async); a pin of such a block waits for its read.
+ *   Until then the buffer is held back from eviction. On the pread
+ *   backend, where such reads would complete in the caller anyway,
+ *   prefetch() reads each run of blocks with one vectored read instead.
+ * - Readahead: pin() tracks the last block pinned in each file. When
+ *   pins move forward one block at a time, it prefetches the next window
+ *   of blocks before they are needed. The window starts at
+ *   READAHEAD_MIN blocks and doubles on each refill up to
+ *   BufferMgrOptions::readahead_max; a pin out of sequence halves it.
+ *
+ * Commit:
+ * - Buffer::set_modified() adds the buffer to its transaction's dirty
+ *   list when the transaction starts modifying it, so flush_all(txnum)
+ *   visits only those buffers instead of the whole pool. Entries for
+ *   buffers since cleaned or taken over by another transaction are
+ *   skipped.
+ * - flush_all() notes the pages still dirty and their highest LSN under
+ *   the partition latches, flushes the log once without them, then
+ *   copies each page under its latches (partition and frame) and writes
+ *   the copies as one batch of asynchronous writes.
+ *
+ * Warm restart (BufferMgrOptions::warm_file):
+ * - save_resident() writes the resident BlockIds, with the warmth their
+ *   replacement policy gives them, to a small file. It runs on
+ *   destruction and, with warm_save_interval_ms, on a timer.
+ * - On construction, a background thread reloads the saved set, warm
+ *   blocks first, in sorted batches of runs read with one vectored read
+ *   each (as load_range()). Only pins of the blocks being read wait for
+ *   it; the read runs without the partition latches.
+ * - The loader only fills frames that have never held a block, so it
+ *   never evicts a page; once a partition has none left, its remaining
+ *   entries are skipped. So are blocks that are already resident, blocks
+ *   past the end of their file, and files that no longer exist.
+ *
+ * Durability: a dirty page written before flush_all(txnum) runs (by
+ * eviction or the writer) is not synced at that point; its file is
+ * remembered and synced by flush_all(txnum).
+ *
  * Corresponds to BufferMgr in Rust (NMDB2/src/buffer/buffermgr.rs)
  *
- * Thread Safety: This class is NOT thread-safe. External synchronization
- * is required if used in multi-threaded context.
+ * Thread Safety: pin(), unpin(), load_range(), flush_all(), available(),
+ * save_resident(), restore_resident() and stats() may be called
+ * concurrently. Each runs under the latch of the partitions it touches,
+ * including the disk read of a block missed by pin(). The vectored
+ * reads of load_range() and prefetch() run without the latches: their
+ * frames are marked in flight first, and pins of those blocks wait.
+ * Pin counts are atomic. The contents of a pinned buffer belong to the
+ * transactions pinning it, which must coordinate among themselves.
  */
 class BufferMgr {
 public:
@@ -52,20 +216,37 @@ public:
      * @param fm the file manager
      * @param lm the log manager
      * @param numbuffs the number of buffers in the pool
+     * @param options the replacement policy and partition count; the
+     *        partition count is clamped to [1, numbuffs]
      */
     BufferMgr(std::shared_ptr<file::FileMgr> fm,
               std::shared_ptr<log::LogMgr> lm,
-              size_t numbuffs);
+              size_t numbuffs,
+              const BufferMgrOptions& options = {});
+
+    /**
+     * Stops the background writer and the warm restart loader, if
+     * running, and saves the resident set to warm_file if one is set.
+     * Dirty pages are not flushed.
+     */
+    ~BufferMgr();
+
+    BufferMgr(const BufferMgr&) = delete;
+    BufferMgr& operator=(const BufferMgr&) = delete;
 
     /**
-     * Returns the number of available (unpinned) buffers.
+     * Returns the number of available (unpinned) buffers, summed over
+     * all partitions. Under concurrent use this is only a snapshot.
      *
      * @return available buffer count
      */
     size_t available() const;
 
     /**
-     * Flushes all buffers modified by the specified transaction.
+     * Flushes all buffers modified by the specified transaction, then
+     * syncs each file they belong to once, including files that received
+     * the transaction's pages earlier without a sync. Only the buffers on
+     * the transaction's dirty list are visited.
      *
      * @param txnum the transaction number
      */
@@ -76,17 +257,58 @@ public:
      *
      * If the block is already in the pool, returns its index.
      * Otherwise, allocates an unpinned buffer and assigns it to the block.
-     * If no unpinned buffers are available, waits up to max_time_ ms.
+     * If no unpinned buffers are available, waits in FIFO order up to
+     * max_time_ ms for one to be unpinned.
      *
      * @param blk the block to pin
+     * @param ring if given, a miss recycles one of the ring's buffers
      * @return the buffer index
      * @throws BufferAbortException if no buffer available after timeout
      */
-    size_t pin(const file::BlockId& blk);
+    size_t pin(const file::BlockId& blk, BufferRing* ring = nullptr);
+
+    /**
+     * Loads a run of consecutive blocks into unpinned buffers with one
+     * vectored read (FileMgr::read_range), so that pinning them later
+     * finds them already resident.
+     *
+     * Only the blocks from first up to the first one already in the pool
+     * are loaded. The run is also limited to the available buffers and to
+     * the end of the file, and stops at the first block whose partition
+     * has no unpinned buffer or has pins waiting. Loaded buffers are left
+     * unpinned.
+     *
+     * @param filename the file to read from
+     * @param first the first block number of the run
+     * @param count the maximum number of blocks to load
+     * @param ring if given, the blocks are loaded into the ring's buffers
+     * @return the number of blocks loaded
+     */
+    size_t load_range(const std::string& filename, int32_t first, size_t count,
+                      BufferRing* ring = nullptr);
+
+    /**
+     * Hints that blocks [first, first + count) will be pinned soon, and
+     * starts reading the ones not yet resident into unpinned buffers.
+     * Returns without waiting for the reads.
+     *
+     * Blocks past the end of the file, blocks whose partition has no
+     * unpinned buffer or has pins waiting, and blocks beyond half of the
+     * currently available buffers are skipped.
+     *
+     * @param filename the file to read from
+     * @param first the first block number
+     * @param count the number of blocks
+     * @param ring if given, the blocks are read into the ring's buffers
+     * @return the number of reads started
+     */
+    size_t prefetch(const std::string& filename, int32_t first, size_t count,
+                    BufferRing* ring = nullptr);
 
     /**
      * Unpins the buffer at the specified index.
-     * Decrements the pin count and increases available count if needed.
+     * Decrements the pin count. If the buffer becomes unpinned, increases
+     * the available count and wakes the oldest waiter of its partition.
      *
      * @param idx the buffer index
      */
@@ -102,12 +324,70 @@ public:
 
     /**
      * Sets the maximum wait time in milliseconds.
-     * (For testing purposes)
+     * (For testing purposes; call before sharing the manager)
      *
      * @param max_time_ms the timeout in milliseconds
      */
     void set_max_time(uint64_t max_time_ms);
 
+    /**
+     * Writes the resident blocks and their replacement warmth to a file,
+     * replacing it atomically. Blocks still being prefetched are left out.
+     *
+     * @param path the file to write
+     * @return the number of blocks saved
+     * @throws std::runtime_error if the file cannot be written
+     */
+    size_t save_resident(const std::string& path);
+
+    /**
+     * Loads the blocks listed in a file written by save_resident() into
+     * frames that have never held a block, as the warm restart loader
+     * does. A missing or malformed file loads nothing.
+     *
+     * @param path the file to read
+     * @return the number of blocks loaded
+     */
+    size_t restore_resident(const std::string& path);
+
+    /**
+     * Blocks until the warm restart loader started by the constructor
+     * has finished, if there is one.
+     */
+    void wait_for_restore();
+
+    /**
+     * Returns the pin, eviction and background write counts so far.
+     */
+    BufferStats stats() const;
+
+    /**
+     * Returns the average number of pages per second written by the
+     * background writer since it started, or 0 if there is none.
+     */
+    double writer_rate() const;
+
+    /**
+     * Returns the replacement policy in use.
+     */
+    ReplacementKind replacement_policy() const;
+
+    /**
+     * Returns the number of partitions the pool is split into.
+     */
+    size_t num_partitions() const;
+
+    /**
+     * Returns the total number of buffers in the pool.
+     */
+    size_t num_buffers() const;
+
+    /**
+     * Returns where the frames' page bytes live. This is HugePages if
+     * HugeTlb was requested but no huge pages could be mapped.
+     */
+    FrameMemory frame_memory() const;
+
     /**
      * Returns the file manager.
      *
@@ -116,46 +396,295 @@ public:
     std::shared_ptr<file::FileMgr> file_mgr() const;
 
 private:
+    friend class Buffer;  // reports dirtied buffers through note_dirty()
+
+    /**
+     * A pin() parked in a partition's wait queue.
+     */
+    struct Waiter {
+        std::condition_variable cv;
+        bool signaled = false;  // under the partition latch; set by wake_next()
+    };
+
+    /**
+     * A vectored read of a run of blocks by read_run(), made without the
+     * partition latches. Shared by the in-flight entries of its frames.
+     */
+    struct RunRead {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::atomic<bool> done{false};
+        bool ok = false;  // under mutex, once done
+    };
+
+    /**
+     * A read into a buffer that has not been waited for: an asynchronous
+     * prefetch read (handle), or a frame of a run read (run).
+     */
+    struct InFlightRead {
+        file::IoHandle handle;
+        std::shared_ptr<RunRead> run;
+
+        bool done() const {
+            return run ? run->done.load(std::memory_order_acquire) : handle.done();
+        }
+    };
+
+    /**
+     * One independently latched slice of the pool: buffers
+     * [first, first + size). The policy works on indices relative to
+     * first; the page table maps to absolute buffer indices.
+     */
+    struct Partition {
+        std::mutex latch;
+        size_t index = 0;
+        size_t first = 0;
+        size_t size = 0;
+        std::unordered_map<file::BlockId, size_t> page_table;  // resident block -> buffer index
+        std::unique_ptr<ReplacementPolicy> policy;
+        std::atomic<size_t> num_available{0};  // written under latch, read without
+        std::list<Waiter*> waiters;             // pins waiting for a buffer, oldest first
+        std::unordered_map<size_t, InFlightRead> in_flight;  // reads not yet waited for
+        size_t free_cursor = 0;  // frames [first, first + free_cursor) have held a block
+        BufferStats stats;
+    };
+
+    /**
+     * Returns the partition a block belongs to.
+     */
+    Partition& partition_of(const file::BlockId& blk);
+
+    /**
+     * Returns the partition that owns a buffer index.
+     */
+    Partition& partition_at(size_t idx);
+
     /**
      * Attempts to pin a buffer to the block without waiting.
+     * Requires the partition latch.
      *
+     * @param part the block's partition
      * @param blk the block to pin
-     * @return the buffer index, or std::nullopt if pool is full
+     * @param may_evict whether a buffer may be assigned if blk is not resident
+     * @param ring the scan's ring, or nullptr
+     * @return the buffer index, or std::nullopt if the partition is full
+     */
+    std::optional<size_t> try_to_pin(Partition& part, const file::BlockId& blk,
+                                     bool may_evict, BufferRing* ring);
+
+    /**
+     * Chooses a buffer for a new block: the ring's oldest reusable
+     * buffer if there is one, else the replacement policy's victim.
+     * Requires the partition latch.
+     *
+     * @param part the partition to choose from
+     * @param ring the scan's ring, or nullptr
+     * @param taken buffers already chosen for the same load_range()
+     * @return the buffer index, or std::nullopt if all pinned
+     */
+    std::optional<size_t> choose_victim(Partition& part, BufferRing* ring,
+                                        const std::vector<size_t>& taken);
+
+    /**
+     * Records that the ring placed blk in a buffer. The buffer joins the
+     * ring if it is not already a member and the ring has room.
+     * Requires the partition latch.
      */
-    std::optional<size_t> try_to_pin(const file::BlockId& blk);
+    void ring_record(Partition& part, BufferRing& ring, size_t idx, const file::BlockId& blk);
+
+    /**
+     * Returns how many buffers a ring may own in each partition.
+     */
+    size_t ring_share(const BufferRing& ring) const;
+
+    /**
+     * What read_run() is loading blocks for.
+     */
+    enum class RunMode {
+        Load,      // load_range(): any victim
+        Prefetch,  // counted and marked as prefetches
+        Restore    // warm restart: only frames that never held a block
+    };
+
+    /**
+     * Implements load_range(), pread-backend prefetches and warm restart
+     * runs. With warm set (Restore only), each loaded frame is rewarmed.
+     *
+     * The frames are chosen and published under the partition latches
+     * with a shared RunRead in flight, so pins of those blocks wait in
+     * finish_read(). The read itself runs without the latches; then each
+     * frame is finished under its own latch.
+     */
+    size_t read_run(const std::string& filename, int32_t first, size_t count,
+                    BufferRing* ring, RunMode mode, bool warm = false);
+
+    /**
+     * Takes the next frame of the partition that has never held a block,
+     * or std::nullopt if there is none. Requires the partition latch.
+     */
+    std::optional<size_t> take_free_frame(Partition& part);
+
+    /**
+     * Body of the warm restart thread: reloads warm_file, then saves it
+     * every warm_save_interval_ms until stopped.
+     */
+    void warm_loop();
+
+    /**
+     * Returns true once the destructor has asked the warm restart thread
+     * to stop.
+     */
+    bool warm_stopping();
+
+    /**
+     * Waits for the read into a buffer, if one is in flight, and releases
+     * the buffer for eviction. If the read failed, the block is
+     * dropped from the page table. Requires the partition latch.
+     *
+     * @return false if a read was in flight and failed
+     */
+    bool finish_read(Partition& part, size_t idx);
+
+    /**
+     * Finishes every read of the partition that has completed.
+     * Requires the partition latch.
+     */
+    void reap_reads(Partition& part);
+
+    /**
+     * Updates the file's readahead state after a pin of blk and, on a
+     * sequential pin, prefetches the next window. Takes no partition
+     * latch on entry.
+     */
+    void readahead(const file::BlockId& blk, BufferRing* ring);
+
+    /**
+     * Per-file sequential access tracking for readahead().
+     */
+    struct ReadaheadState {
+        int32_t next = -1;      // block that would continue the sequence
+        int32_t ahead_end = 0;  // end of the blocks already prefetched
+        size_t window = 0;      // blocks to prefetch on the next refill
+    };
+
+    struct ReadaheadStripe {
+        std::mutex mutex;
+        std::unordered_map<file::FileId, ReadaheadState> files;
+    };
+
+    static constexpr size_t READAHEAD_MIN = 4;
+    static constexpr size_t READAHEAD_STRIPES = 16;
+
+    /**
+     * Dirty lists of the transactions whose number maps to the stripe.
+     * A list may hold an index more than once, or buffers that are no
+     * longer modified by the transaction; flush_all() filters them.
+     */
+    struct DirtyStripe {
+        std::mutex mutex;
+        std::unordered_map<size_t, std::vector<size_t>> txns;  // txnum -> buffer indices
+    };
+
+    static constexpr size_t DIRTY_STRIPES = 16;
+    static constexpr size_t RESTORE_BATCH = 1024;  // saved entries per warm restart batch
+
+    /**
+     * Signals the oldest waiter of the partition, if any.
+     * Requires the partition latch.
+     */
+    void wake_next(Partition& part);
 
     /**
      * Finds a buffer already assigned to the block.
+     * Requires the partition latch.
      *
+     * @param part the block's partition
      * @param blk the block to find
      * @return the buffer index, or std::nullopt if not found
      */
-    std::optional<size_t> find_existing_buffer(const file::BlockId& blk);
+    std::optional<size_t> find_existing_buffer(Partition& part, const file::BlockId& blk);
 
     /**
-     * Chooses an unpinned buffer for eviction.
-     * Simple strategy: first unpinned buffer found.
+     * Assigns a buffer to a block and keeps the page table in sync:
+     * the buffer's old block is removed and the new one added.
+     * Requires the partition latch.
      *
-     * @return the buffer index, or std::nullopt if all pinned
+     * @param part the partition owning the buffer
+     * @param idx the buffer index
+     * @param blk the new block
+     * @param read whether to read the block's contents from disk
+     */
+    void assign_buffer(Partition& part, size_t idx, const file::BlockId& blk, bool read);
+
+    /**
+     * Remembers that a page of txnum was written to filename without a
+     * sync, so that flush_all(txnum) syncs the file.
+     */
+    void note_unsynced(size_t txnum, const std::string& filename);
+
+    /**
+     * Adds a buffer to the dirty list of txnum. Called by
+     * Buffer::set_modified() when txnum starts modifying the buffer.
+     */
+    void note_dirty(size_t txnum, size_t idx);
+
+    /**
+     * Body of the background writer thread.
+     */
+    void writer_loop();
+
+    /**
+     * Writes up to writer_batch unpinned dirty pages, continuing the
+     * sweep where the previous round stopped.
      */
-    std::optional<size_t> choose_unpinned_buffer();
+    void write_round();
 
     /**
-     * Checks if waiting time has exceeded the maximum.
+     * Chooses an unpinned buffer of the partition for eviction, as
+     * decided by its replacement policy. Requires the partition latch.
      *
-     * @param start_time the time when waiting started
-     * @return true if timeout expired
+     * @param part the partition to choose from
+     * @return the buffer index, or std::nullopt if all pinned
      */
-    bool waiting_too_long(
-        const std::chrono::steady_clock::time_point& start_time) const;
+    std::optional<size_t> choose_unpinned_buffer(Partition& part);
 
 private:
     static constexpr uint64_t MAX_TIME = 10000;  // 10 seconds in ms
 
     std::shared_ptr<file::FileMgr> fm_;
-    std::vector<Buffer> bufferpool_;
-    size_t num_available_;
-    uint64_t max_time_;
+    std::shared_ptr<log::LogMgr> lm_;
+    std::unique_ptr<FrameArena> arena_;  // frame bytes, unless Heap; outlives bufferpool_
+    std::deque<Buffer> bufferpool_;  // Buffer is not movable (atomic pin count)
+    std::vector<std::unique_ptr<Partition>> partitions_;
+    std::vector<uint32_t> partition_index_;  // buffer index -> partition
+    ReplacementKind policy_kind_;
+    std::atomic<uint64_t> max_time_;
+
+    std::mutex unsynced_mutex_;
+    std::unordered_map<size_t, std::unordered_set<std::string>> unsynced_;  // txnum -> files
+
+    std::vector<uint8_t> prefetched_;  // buffer index -> prefetched, not pinned since (partition latch)
+    size_t readahead_max_;
+    std::array<ReadaheadStripe, READAHEAD_STRIPES> readahead_;  // striped by file id
+    std::array<DirtyStripe, DIRTY_STRIPES> dirty_;              // striped by txnum
+
+    size_t writer_batch_;
+    std::chrono::milliseconds writer_interval_;
+    size_t writer_cursor_ = 0;  // next buffer index to sweep (writer thread only)
+    std::chrono::steady_clock::time_point writer_started_;
+    std::mutex writer_mutex_;
+    std::condition_variable writer_cv_;
+    bool writer_stop_ = false;  // under writer_mutex_
+    std::thread writer_;
+
+    std::string warm_file_;
+    std::chrono::milliseconds warm_interval_;
+    std::mutex save_mutex_;  // serializes save_resident() file writes
+    std::mutex warm_mutex_;
+    std::condition_variable warm_cv_;
+    bool warm_stop_ = false;   // under warm_mutex_
+    bool restoring_ = false;   // under warm_mutex_; the loader has not finished
+    std::thread warm_;
 };
 
 } // namespace buffer
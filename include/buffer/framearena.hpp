@@ -0,0 +1,93 @@
+#ifndef FRAMEARENA_HPP
+#define FRAMEARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace buffer {
+
+/**
+ * Selects where BufferMgr keeps the bytes of its frames.
+ */
+enum class FrameMemory {
+    Heap,        // a separate aligned allocation per page (the original layout)
+    Arena,       // one contiguous anonymous mapping for all frames
+    HugePages,   // Arena, advised to use transparent huge pages (MADV_HUGEPAGE)
+    HugeTlb      // Arena from explicit huge pages (MAP_HUGETLB); falls back to HugePages
+};
+
+/**
+ * FrameArena is one contiguous, zero-filled block of memory holding the
+ * page bytes of every frame in a buffer pool, so that a large pool costs
+ * a single mapping instead of one allocation per page and covers fewer
+ * TLB entries.
+ *
+ * Frames are laid out back to back, each starting at a multiple of
+ * file::Page::alignment_for(frame_size), so they can be used directly as
+ * O_DIRECT I/O buffers. The memory is mapped lazily by the kernel;
+ * untouched frames cost nothing.
+ *
+ * With FrameMemory::HugeTlb the mapping comes from the reserved huge page
+ * pool (vm.nr_hugepages). If that fails, e.g. because too few huge pages
+ * are reserved, the arena is mapped normally and advised as HugePages.
+ * Transparent huge pages are only a hint; the kernel may ignore it.
+ */
+class FrameArena {
+public:
+    /**
+     * Maps an arena.
+     *
+     * @param frames the number of frames
+     * @param frame_size the page size of each frame in bytes
+     * @param memory Arena, HugePages or HugeTlb
+     * @throws std::bad_alloc if the memory cannot be mapped
+     */
+    FrameArena(size_t frames, size_t frame_size, FrameMemory memory);
+
+    /**
+     * Unmaps the arena. Every page built over it must be gone.
+     */
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * Returns the first byte of a frame.
+     *
+     * @param idx the frame index, less than frames()
+     */
+    uint8_t* frame(size_t idx) const { return base_ + idx * stride_; }
+
+    /**
+     * Returns the number of frames.
+     */
+    size_t frames() const { return frames_; }
+
+    /**
+     * Returns the distance in bytes between consecutive frames.
+     */
+    size_t stride() const { return stride_; }
+
+    /**
+     * Returns the size of the mapping in bytes.
+     */
+    size_t bytes() const { return bytes_; }
+
+    /**
+     * Returns how the arena was actually mapped: HugePages if HugeTlb was
+     * requested but unavailable, otherwise the requested kind.
+     */
+    FrameMemory memory() const { return memory_; }
+
+private:
+    uint8_t* base_ = nullptr;
+    size_t frames_;
+    size_t stride_;
+    size_t bytes_ = 0;
+    FrameMemory memory_;
+};
+
+} // namespace buffer
+
+#endif // FRAMEARENA_HPP
@@ -0,0 +1,102 @@
+#ifndef REPLACEMENTPOLICY_HPP
+#define REPLACEMENTPOLICY_HPP
+
+#include "file/blockid.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace buffer {
+
+/**
+ * Selects the buffer replacement policy used by BufferMgr.
+ */
+enum class ReplacementKind {
+    Naive,  // lowest-numbered unpinned frame (the original behaviour)
+    Clock,  // second chance: a reference bit per frame and a rotating hand
+    LruK,   // LRU-2: evicts the frame whose second-most-recent access is oldest
+    TwoQ    // 2Q: FIFO probation queue, LRU main queue, ghost list of evicted blocks
+};
+
+/**
+ * ReplacementPolicy decides which frame BufferMgr reuses when a block
+ * that is not resident has to be brought in.
+ *
+ * BufferMgr reports every event the policy needs to track:
+ * - loaded():   a frame was assigned to a new block (a miss)
+ * - accessed(): a resident block was pinned again (a hit)
+ * - pinned() / unpinned(): a frame's pin count left or returned to zero
+ *
+ * For warm restarts, warmth() summarizes what the policy knows about a
+ * frame, and rewarm() gives that back to a frame just reloaded.
+ *
+ * Only unpinned frames are evictable. All frames start unassigned and
+ * unpinned. Every policy except Naive uses unassigned frames before
+ * evicting a block.
+ *
+ * Thread Safety: not thread-safe; BufferMgr serializes all calls.
+ */
+class ReplacementPolicy {
+public:
+    virtual ~ReplacementPolicy() = default;
+
+    /**
+     * Records that a frame now holds blk. Counts as an access.
+     */
+    virtual void loaded(size_t frame, const file::BlockId& blk) = 0;
+
+    /**
+     * Records an access to the block already held by a frame.
+     */
+    virtual void accessed(size_t frame) = 0;
+
+    /**
+     * Records that a frame became pinned and must not be evicted.
+     */
+    virtual void pinned(size_t frame) = 0;
+
+    /**
+     * Records that a frame is no longer pinned and may be evicted.
+     */
+    virtual void unpinned(size_t frame) = 0;
+
+    /**
+     * Chooses an unpinned frame to reuse. Does not change which frames
+     * are evictable; the caller pins the frame or calls loaded() next.
+     *
+     * @return the frame, or std::nullopt if every frame is pinned
+     */
+    virtual std::optional<size_t> victim() = 0;
+
+    /**
+     * Returns 1 if the frame's block has been accessed again since it
+     * was loaded, in a way the policy still remembers (so it would keep
+     * the block over one used only once), else 0.
+     */
+    virtual uint8_t warmth(size_t) const { return 0; }
+
+    /**
+     * Gives a frame that was just loaded the standing of a block with
+     * warmth 1. By default, records another access.
+     */
+    virtual void rewarm(size_t frame) { accessed(frame); }
+
+    /**
+     * Returns which policy this is.
+     */
+    virtual ReplacementKind kind() const = 0;
+};
+
+/**
+ * Creates a replacement policy for a pool of the given size.
+ *
+ * @param kind the policy to create
+ * @param num_frames the number of frames in the pool
+ */
+std::unique_ptr<ReplacementPolicy> make_replacement_policy(ReplacementKind kind,
+                                                           size_t num_frames);
+
+} // namespace buffer
+
+#endif // REPLACEMENTPOLICY_HPP
@@ -1,6 +1,7 @@
 #ifndef BLOCKID_HPP
 #define BLOCKID_HPP
 
+#include "file/fileregistry.hpp"
 #include <string>
 #include <functional>
 
@@ -10,6 +11,10 @@ namespace file {
  * BlockId uniquely identifies a block in the file system.
  * A block is identified by its filename and block number.
  *
+ * The filename is held as an interned FileId (see FileRegistry), so a
+ * BlockId is a trivially copyable 64-bit value: copying never allocates,
+ * and equality and hashing never touch the name.
+ *
  * Corresponds to BlockId in Rust (NMDB2/src/file/blockid.rs)
  */
 class BlockId {
@@ -21,15 +26,27 @@ public:
      */
     BlockId(const std::string& filename, int32_t blknum);
 
+    /**
+     * Creates a new block identifier from an already interned file.
+     * @param file_id the file's id from FileRegistry::id_of()
+     * @param blknum the block number within the file
+     */
+    BlockId(FileId file_id, int32_t blknum) : file_id_(file_id), blknum_(blknum) {}
+
     /**
      * Returns the name of the file where this block is located.
      */
     const std::string& file_name() const;
 
+    /**
+     * Returns the interned id of the file where this block is located.
+     */
+    FileId file_id() const { return file_id_; }
+
     /**
      * Returns the block number within the file.
      */
-    int32_t number() const;
+    int32_t number() const { return blknum_; }
 
     /**
      * String representation for debugging.
@@ -37,14 +54,16 @@ public:
     std::string to_string() const;
 
     // Equality comparison
-    bool operator==(const BlockId& other) const;
-    bool operator!=(const BlockId& other) const;
+    bool operator==(const BlockId& other) const {
+        return file_id_ == other.file_id_ && blknum_ == other.blknum_;
+    }
+    bool operator!=(const BlockId& other) const { return !(*this == other); }
 
-    // For use in ordered containers (std::map, std::set)
+    // For use in ordered containers (std::map, std::set); orders by filename
     bool operator<(const BlockId& other) const;
 
 private:
-    std::string filename_;
+    FileId file_id_;
     int32_t blknum_;
 };
 
@@ -54,7 +73,13 @@ private:
 namespace std {
     template<>
     struct hash<file::BlockId> {
-        size_t operator()(const file::BlockId& blk) const noexcept;
+        size_t operator()(const file::BlockId& blk) const noexcept {
+            // Multiplicative hash of the packed (file id, block number) pair
+            uint64_t key = (static_cast<uint64_t>(blk.file_id()) << 32) |
+                           static_cast<uint32_t>(blk.number());
+            key *= 0x9e3779b97f4a7c15ULL;
+            return static_cast<size_t>(key ^ (key >> 32));
+        }
     };
 }
 
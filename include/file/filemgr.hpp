@@ -3,18 +3,94 @@
 
 #include "file/blockid.hpp"
 #include "file/page.hpp"
+#include "file/iobackend.hpp"
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <memory>
 #include <mutex>
-#include <fstream>
+#include <shared_mutex>
+#include <atomic>
 
 namespace file {
 
+/**
+ * Expected access pattern for a file, passed to FileMgr::advise().
+ */
+enum class AccessHint {
+    Normal,      // no particular order
+    Sequential,  // forward scan (e.g. TableScan)
+    Reverse      // backward scan (e.g. LogIterator)
+};
+
+/**
+ * When written data is forced to stable storage.
+ */
+enum class SyncPolicy {
+    None,       // never synced; the file does not need to survive a crash
+    Deferred,   // synced by FileMgr::sync()/sync_all(), once for all writes since the last sync
+    EveryWrite  // synced before every write returns
+};
+
+/**
+ * Construction-time settings for FileMgr.
+ *
+ * Files are classified by name for durability: names starting with "temp"
+ * are temporary files, names ending in ".log" are log files, and every other
+ * file (e.g. "*.tbl") is a data file.
+ */
+struct FileMgrOptions {
+    IoBackendKind io_backend = IoBackendKind::Pread;  // backend for the async API
+    unsigned io_queue_depth = 64;                      // io_uring submission queue size
+    bool mmap_reads = false;                           // serve reads from mapped files
+    bool direct_io = false;                            // open files with O_DIRECT
+    size_t extent_size = 1 << 20;                      // bytes preallocated per file growth; 0 = none
+    SyncPolicy temp_sync = SyncPolicy::None;           // temp* files
+    SyncPolicy log_sync = SyncPolicy::Deferred;        // *.log files, synced on log flush
+    SyncPolicy data_sync = SyncPolicy::Deferred;       // all other files, synced by flush_all
+};
+
+/**
+ * Handle for an asynchronous read or write issued through FileMgr.
+ * The page passed to the request must stay alive until it completes.
+ */
+class IoHandle {
+public:
+    IoHandle() = default;
+
+    /**
+     * Returns true once the request has completed (successfully or not).
+     * A default-constructed handle is always done.
+     */
+    bool done() const {
+        return !completion_ || completion_->done.load(std::memory_order_acquire);
+    }
+
+private:
+    friend class FileMgr;
+
+    explicit IoHandle(std::shared_ptr<IoCompletion> c) : completion_(std::move(c)) {}
+
+    std::shared_ptr<IoCompletion> completion_;
+};
+
 /**
  * FileMgr manages the database files on disk.
  * It provides methods to read and write disk blocks.
  * All file operations are thread-safe.
  *
+ * Concurrency: the open-file table is guarded by a reader/writer lock that
+ * is only taken exclusively the first time a file is opened. Reads and
+ * writes are positioned pread/pwrite calls and take no per-file lock, so
+ * I/O on different files and different blocks of the same file proceeds
+ * in parallel. Appends serialize on a per-file extension lock.
+ *
+ * Durability: a completed write() is only guaranteed to be in the kernel.
+ * Each file gets a SyncPolicy from its name (see FileMgrOptions) that says
+ * when it is fdatasync'ed. With the default Deferred policy, many writes are
+ * made durable by a single sync() (LogMgr::flush for the log,
+ * BufferMgr::flush_all for data files).
+ *
  * Corresponds to FileMgr in Rust (NMDB2/src/file/filemgr.rs)
  */
 class FileMgr {
@@ -26,8 +102,19 @@ public:
      *
      * @param db_directory the directory where database files are stored
      * @param blocksize the size of each block in bytes
+     * @param options backend and tuning settings
+     * @throws std::invalid_argument if direct_io and mmap_reads are both set
      */
-    FileMgr(const std::string& db_directory, size_t blocksize);
+    FileMgr(const std::string& db_directory, size_t blocksize,
+            const FileMgrOptions& options = FileMgrOptions());
+
+    /**
+     * Closes every file descriptor held in the open-file table.
+     */
+    ~FileMgr();
+
+    FileMgr(const FileMgr&) = delete;
+    FileMgr& operator=(const FileMgr&) = delete;
 
     /**
      * Reads a block from disk into the provided page.
@@ -46,8 +133,90 @@ public:
      */
     void write(const BlockId& blk, Page& page);
 
+    /**
+     * Reads a contiguous run of blocks with a single vectored read
+     * (preadv), instead of one read() call per block.
+     * Blocks beyond the end of the file leave their pages unchanged.
+     *
+     * @param filename the name of the file
+     * @param first_blk the first block of the run
+     * @param count the number of blocks to read
+     * @param pages array of count pages, one per block
+     */
+    void read_range(const std::string& filename, int32_t first_blk, size_t count, Page* pages);
+
+    /**
+     * Same as above, for pages that are not stored contiguously
+     * (such as the pages of buffer pool frames).
+     *
+     * @param pages array of count page pointers, one per block
+     */
+    void read_range(const std::string& filename, int32_t first_blk, size_t count,
+                    Page* const* pages);
+
+    /**
+     * Writes a contiguous run of blocks with a single vectored write
+     * (pwritev), instead of one write() call per block. Writing past the
+     * end extends the file.
+     *
+     * @param filename the name of the file
+     * @param first_blk the first block of the run
+     * @param count the number of blocks to write
+     * @param pages array of count page pointers, one per block
+     */
+    void write_range(const std::string& filename, int32_t first_blk, size_t count,
+                     Page* const* pages);
+
+    /**
+     * Queues an asynchronous read of a block into the page.
+     * As with read(), a block beyond the end of the file leaves the page
+     * unchanged; such a request completes immediately.
+     *
+     * @param blk the block identifier
+     * @param page the page to read into; must outlive the request
+     * @return a handle to wait on
+     */
+    IoHandle read_async(const BlockId& blk, Page& page);
+
+    /**
+     * Queues an asynchronous write of the page to a block.
+     *
+     * @param blk the block identifier
+     * @param page the page to write; must outlive the request
+     * @return a handle to wait on
+     */
+    IoHandle write_async(const BlockId& blk, Page& page);
+
+    /**
+     * Submits every queued asynchronous request as one batch.
+     */
+    void submit();
+
+    /**
+     * Blocks until the request has completed, submitting it first if needed.
+     *
+     * @param handle the request handle
+     * @throws std::runtime_error if the I/O failed
+     */
+    void wait(const IoHandle& handle);
+
+    /**
+     * Blocks until every outstanding asynchronous request has completed.
+     */
+    void wait_all();
+
+    /**
+     * Returns the backend actually in use for asynchronous I/O, which is
+     * IoBackendKind::Pread if io_uring was requested but unavailable.
+     */
+    IoBackendKind io_backend() const;
+
     /**
      * Appends a new block to the end of the specified file.
+     * The file's disk space is reserved in extents of
+     * FileMgrOptions::extent_size with fallocate, so an append that lands
+     * inside an already reserved extent only updates the file size; the new
+     * block reads back as zeros.
      *
      * @param filename the name of the file
      * @return the block identifier of the newly appended block
@@ -62,6 +231,81 @@ public:
      */
     size_t length(const std::string& filename);
 
+    /**
+     * Returns whether the file exists in the database directory. Unlike
+     * the other file operations, this does not create it.
+     *
+     * @param filename the name of the file
+     */
+    bool exists(const std::string& filename) const;
+
+    /**
+     * Tells the file manager how a file is about to be accessed, so that
+     * the kernel can read ahead in the right direction. Uses madvise on
+     * the mapping in mmap mode and posix_fadvise otherwise. Does nothing
+     * for a file that does not exist.
+     *
+     * @param filename the name of the file
+     * @param hint the expected access pattern
+     */
+    void advise(const std::string& filename, AccessHint hint);
+
+    /**
+     * Forces the file's written data to stable storage with fdatasync, if
+     * it has been written since its last sync. One call covers every write
+     * made before it. Files with SyncPolicy::None are never synced.
+     *
+     * @param filename the name of the file
+     * @throws std::runtime_error if fdatasync fails
+     */
+    void sync(const std::string& filename);
+
+    /**
+     * Calls sync() on every open file with unsynced writes.
+     *
+     * @throws std::runtime_error if fdatasync fails
+     */
+    void sync_all();
+
+    /**
+     * Returns the durability policy that applies to a file name.
+     *
+     * @param filename the name of the file
+     */
+    SyncPolicy sync_policy(const std::string& filename) const;
+
+    /**
+     * Returns the number of fdatasync calls made so far.
+     */
+    size_t sync_count() const;
+
+    /**
+     * Returns the byte order of pages in this database. Directories
+     * created by this version use ByteOrder::LittleEndian (page format 2);
+     * directories that already held data without a format marker are
+     * treated as ByteOrder::BigEndian (format 1) and stay that way.
+     * Pages returned by read() carry this order; write() rejects pages
+     * with a different one.
+     */
+    ByteOrder byte_order() const;
+
+    /**
+     * Returns the interned id of a filename, for building BlockIds
+     * without repeating the name lookup (see FileRegistry).
+     *
+     * @param filename the name of the file
+     */
+    FileId file_id(const std::string& filename) const;
+
+    /**
+     * Returns true if the file is open with O_DIRECT. This is false when
+     * direct I/O was not requested, the filesystem does not support it,
+     * or the file does not exist (it is not created).
+     *
+     * @param filename the name of the file
+     */
+    bool is_direct(const std::string& filename);
+
     /**
      * Returns true if this database was newly created.
      */
@@ -73,11 +317,54 @@ public:
     size_t block_size() const;
 
 private:
+    /**
+     * A read-only shared mapping of the first len bytes of a file.
+     */
+    struct Mapping {
+        const uint8_t* base;
+        size_t len;
+    };
+
+    /**
+     * An entry in the open-file table. The descriptor stays open for the
+     * lifetime of the FileMgr, and the length is tracked in memory so that
+     * block accesses never need to seek or stat the file.
+     */
+    struct OpenFile {
+        std::string name;
+        int fd;
+        bool direct;                 // opened with O_DIRECT
+        std::atomic<size_t> blocks;  // current length in blocks
+        std::mutex extend_mutex;     // serializes append() on this file
+        size_t reserved = 0;         // blocks known to be allocated on disk (under extend_mutex)
+        bool can_fallocate = true;   // cleared if the file system rejects fallocate
+        SyncPolicy sync;             // durability policy for this file
+        std::atomic<bool> dirty{false};  // written since the last sync (Deferred only)
+
+        // mmap mode only
+        std::atomic<const Mapping*> mapping{nullptr};     // newest mapping
+        std::vector<std::unique_ptr<Mapping>> mappings;   // every mapping made, kept alive
+        std::mutex map_mutex;                             // serializes remapping
+        std::atomic<AccessHint> hint{AccessHint::Normal};
+
+        OpenFile(const std::string& name, int fd, bool direct, size_t blocks, SyncPolicy sync)
+            : name(name), fd(fd), direct(direct), blocks(blocks), sync(sync) {}
+    };
+
     std::string db_directory_;
     size_t blocksize_;
     bool is_new_;
-    std::unordered_map<std::string, size_t> open_files_;  // filename -> size in blocks
-    mutable std::mutex mutex_;  // Protect file operations
+    bool mmap_reads_;
+    bool direct_io_;
+    size_t extent_blocks_;  // blocks reserved per fallocate; 0 = no preallocation
+    ByteOrder byte_order_;
+    SyncPolicy temp_sync_;
+    SyncPolicy log_sync_;
+    SyncPolicy data_sync_;
+    std::atomic<size_t> sync_count_{0};
+    std::unique_ptr<IoBackend> io_;
+    std::unordered_map<FileId, std::unique_ptr<OpenFile>> open_files_;  // file id -> open file
+    mutable std::shared_mutex table_mutex_;  // Protects open_files_ (not the I/O itself)
 
     /**
      * Gets the full path to a database file.
@@ -85,14 +372,73 @@ private:
     std::string get_file_path(const std::string& filename) const;
 
     /**
-     * Opens or creates a file and returns a stream.
+     * Returns the open-file entry for a file, opening (or creating) it
+     * on first use. Entries are never removed, so the reference stays
+     * valid for the lifetime of the FileMgr.
+     */
+    OpenFile& get_file(const std::string& filename);
+    OpenFile& get_file(FileId id);
+
+    /**
+     * Like get_file(), but for the read paths: a file that does not
+     * exist is not created, and nullptr is returned instead.
+     */
+    OpenFile* find_file(const std::string& filename);
+    OpenFile* find_file(FileId id);
+
+    /**
+     * Looks up or opens the entry for get_file() and find_file().
+     */
+    OpenFile* open_entry(FileId id, bool create);
+
+    /**
+     * Opens a file for open_entry(), with O_DIRECT if configured and
+     * supported. Sets direct to whether O_DIRECT is in effect. Returns -1
+     * if the file does not exist and create is false.
+     */
+    int open_file(const std::string& filepath, bool create, bool& direct);
+
+    /**
+     * Reads the page format marker of the database directory, creating
+     * it on first use, and returns the page byte order it specifies.
+     */
+    ByteOrder load_page_format();
+
+    /**
+     * Throws std::invalid_argument if a page's byte order differs from
+     * the database's.
+     */
+    void check_byte_order(const Page& page) const;
+
+    /**
+     * Applies the file's sync policy after a completed write: syncs it now
+     * (EveryWrite) or marks it for the next sync() (Deferred).
+     */
+    void note_write(OpenFile& f);
+
+    /**
+     * Runs fdatasync on a file and clears its dirty flag.
+     * Returns false if fdatasync failed; the file stays dirty.
+     */
+    bool sync_file(OpenFile& f);
+
+    /**
+     * Raises the tracked length of a file to at least the given number
+     * of blocks. Never shrinks it.
+     */
+    static void extend_length(OpenFile& f, size_t blocks);
+
+    /**
+     * Returns the address of a block inside the file's mapping, creating
+     * a larger mapping first if the current one does not cover it.
      */
-    std::fstream get_file(const std::string& filename, std::ios::openmode mode);
+    const uint8_t* mapped_block(OpenFile& f, int32_t blknum);
 
     /**
-     * Updates the cached file size.
+     * For files read backward, asks the kernel to prefetch the window of
+     * blocks preceding blknum once per window.
      */
-    void update_file_size(const std::string& filename);
+    void prefetch_backward(OpenFile& f, int32_t blknum);
 };
 
 } // namespace file
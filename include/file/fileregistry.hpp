@@ -0,0 +1,53 @@
+#ifndef FILEREGISTRY_HPP
+#define FILEREGISTRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace file {
+
+/**
+ * Small integer that stands for a filename inside a BlockId.
+ */
+using FileId = uint32_t;
+
+/**
+ * FileRegistry interns filenames into FileIds.
+ *
+ * Each distinct filename is assigned the next free id the first time it
+ * is seen and keeps it for the life of the process, so ids can be compared
+ * and hashed in place of the names. Ids are not persistent and must never
+ * be written to disk.
+ *
+ * The registry is process-wide so that a BlockId can be built from a name
+ * without a FileMgr at hand. All methods are thread-safe.
+ */
+class FileRegistry {
+public:
+    /**
+     * Returns the id of a filename, registering it if it is new.
+     *
+     * @param filename the name of the file
+     * @return the file's id
+     */
+    static FileId id_of(const std::string& filename);
+
+    /**
+     * Returns the filename registered under an id.
+     * The reference stays valid for the life of the process.
+     *
+     * @param id an id returned by id_of()
+     * @throws std::out_of_range if the id was never assigned
+     */
+    static const std::string& name_of(FileId id);
+
+    /**
+     * Returns the number of registered filenames.
+     */
+    static size_t size();
+};
+
+} // namespace file
+
+#endif // FILEREGISTRY_HPP
@@ -0,0 +1,122 @@
+#ifndef IOBACKEND_HPP
+#define IOBACKEND_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace file {
+
+/**
+ * Selects how FileMgr performs asynchronous block I/O.
+ */
+enum class IoBackendKind {
+    Pread,    // synchronous pread/pwrite; requests complete at submission
+    IoUring   // Linux io_uring; many requests in flight at once
+};
+
+/**
+ * Completion state for one asynchronous request.
+ * Owned jointly by the submitter's IoHandle and the backend while the
+ * request is in flight.
+ */
+struct IoCompletion {
+    std::atomic<bool> done{false};
+    ssize_t result = 0;       // bytes transferred, or -errno
+    size_t expected = 0;      // bytes requested
+    std::function<void(const IoCompletion&)> on_complete;  // runs once, when reaped
+
+    bool ok() const { return result >= 0 && static_cast<size_t>(result) == expected; }
+};
+
+/**
+ * IoBackend executes positioned reads and writes on raw file descriptors
+ * on behalf of FileMgr's asynchronous API.
+ *
+ * Requests are queued with submit_read()/submit_write() and handed to the
+ * kernel as one batch by submit(). Backends may also submit early when
+ * their queue is full. wait() blocks until a given request has completed.
+ *
+ * All methods are thread-safe.
+ */
+class IoBackend {
+public:
+    virtual ~IoBackend() = default;
+
+    /**
+     * Queues a read of len bytes at offset into buf.
+     */
+    virtual void submit_read(int fd, uint8_t* buf, size_t len, off_t offset,
+                             std::shared_ptr<IoCompletion> c) = 0;
+
+    /**
+     * Queues a write of len bytes from buf at offset.
+     */
+    virtual void submit_write(int fd, const uint8_t* buf, size_t len, off_t offset,
+                              std::shared_ptr<IoCompletion> c) = 0;
+
+    /**
+     * Hands every queued request to the kernel.
+     */
+    virtual void submit() = 0;
+
+    /**
+     * Blocks until the request has completed.
+     */
+    virtual void wait(const IoCompletion& c) = 0;
+
+    /**
+     * Blocks until every submitted request has completed.
+     */
+    virtual void wait_all() = 0;
+
+    /**
+     * Returns which backend this is.
+     */
+    virtual IoBackendKind kind() const = 0;
+};
+
+/**
+ * Reads exactly len bytes at offset, retrying on EINTR and short reads.
+ * Returns false if an I/O error occurred or end of file was reached.
+ */
+bool pread_full(int fd, uint8_t* buf, size_t len, off_t offset);
+
+/**
+ * Writes exactly len bytes at offset, retrying on EINTR and short writes.
+ * Returns false if an I/O error occurred.
+ */
+bool pwrite_full(int fd, const uint8_t* buf, size_t len, off_t offset);
+
+/**
+ * Reads exactly the bytes described by iov[0..iovcnt) starting at offset
+ * with preadv, retrying on EINTR and short reads. The iovec array is
+ * modified while advancing past partial transfers.
+ * Returns false if an I/O error occurred or end of file was reached.
+ */
+bool preadv_full(int fd, struct iovec* iov, int iovcnt, off_t offset);
+
+/**
+ * Writes exactly the bytes described by iov[0..iovcnt) starting at offset
+ * with pwritev, retrying on EINTR and short writes. The iovec array is
+ * modified while advancing past partial transfers.
+ * Returns false if an I/O error occurred.
+ */
+bool pwritev_full(int fd, struct iovec* iov, int iovcnt, off_t offset);
+
+/**
+ * Creates a backend of the requested kind. If io_uring is requested but
+ * unavailable (old kernel, seccomp, etc.), a pread backend is returned.
+ *
+ * @param kind the requested backend
+ * @param queue_depth the io_uring submission queue size
+ */
+std::unique_ptr<IoBackend> make_io_backend(IoBackendKind kind, unsigned queue_depth);
+
+} // namespace file
+
+#endif // IOBACKEND_HPP
@@ -2,16 +2,50 @@
 #define PAGE_HPP
 
 #include <vector>
+#include <atomic>
+#include <memory>
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 
 namespace file {
 
+/**
+ * Byte order of the integers stored in a page.
+ */
+enum class ByteOrder {
+    BigEndian,    // page format 1 (legacy databases)
+    LittleEndian  // page format 2
+};
+
 /**
  * Page represents an in-memory block of data.
  * It provides methods to read and write integers, strings, and byte arrays.
- * All integers are stored in big-endian (network byte order) format.
+ *
+ * Integers are stored in the page's byte order. New databases use
+ * little-endian pages, which are read and written with a single memcpy on
+ * little-endian hosts; databases created before the page format was
+ * versioned are big-endian and are read through the same accessors with a
+ * byte swap (see FileMgr::byte_order()).
+ *
+ * The *_unchecked accessors skip the bounds check, for callers that have
+ * already validated the range (e.g. RecordPage, once per slot).
+ *
+ * A page normally owns its bytes. It can also be pointed at an external,
+ * read-only region (such as a memory-mapped file block) with set_view();
+ * reads then go straight to that region without copying. The first
+ * modification copies the region into the page's own storage, so writes
+ * never touch the external memory. The copy is made once, under a lock,
+ * even when writers to disjoint parts of the page (such as log appenders)
+ * race to it; readers never see the own storage before it is complete.
+ *
+ * Owned storage is aligned (to 4096 bytes when the size is a multiple of
+ * 4096, otherwise to 512 when possible), so pages can be used directly as
+ * O_DIRECT I/O buffers. A page can instead be built over storage owned by
+ * someone else, such as a frame of the buffer pool's arena; it then
+ * neither allocates nor frees it. Copies always own their storage.
  *
  * Corresponds to Page in Rust (NMDB2/src/file/page.rs)
  */
@@ -20,28 +54,74 @@ public:
     /**
      * Creates a new page of the specified size.
      * @param blocksize the size of the page in bytes
+     * @param order the byte order of integers in the page
      */
-    explicit Page(size_t blocksize);
+    explicit Page(size_t blocksize, ByteOrder order = ByteOrder::LittleEndian);
 
     /**
      * Creates a page from existing data.
      * @param data the byte vector to use
+     * @param order the byte order of integers in the data
+     */
+    explicit Page(std::vector<uint8_t> data, ByteOrder order = ByteOrder::LittleEndian);
+
+    /**
+     * Creates a page over caller-owned storage, which is used as is (not
+     * zeroed) and must outlive the page.
+     * @param storage blocksize writable bytes, aligned as alignment_for(blocksize)
+     *        if the page is used for O_DIRECT I/O
+     * @param blocksize the size of the page in bytes
+     * @param order the byte order of integers in the page
      */
-    explicit Page(std::vector<uint8_t> data);
+    Page(uint8_t* storage, size_t blocksize, ByteOrder order = ByteOrder::LittleEndian);
+
+    Page(const Page& other);
+    Page(Page&& other) noexcept;
+    Page& operator=(const Page& other);
+    Page& operator=(Page&& other) noexcept;
 
     /**
      * Reads a 32-bit integer from the specified offset.
      * @param offset the byte offset within the page
      * @return the integer value in host byte order
      */
-    int32_t get_int(size_t offset) const;
+    int32_t get_int(size_t offset) const {
+        check_bounds(offset, 4);
+        return get_int_unchecked(offset);
+    }
 
     /**
      * Writes a 32-bit integer to the specified offset.
      * @param offset the byte offset within the page
      * @param val the integer value to write
      */
-    void set_int(size_t offset, int32_t val);
+    void set_int(size_t offset, int32_t val) {
+        check_bounds(offset, 4);
+        set_int_unchecked(offset, val);
+    }
+
+    /**
+     * Reads a 32-bit integer without checking that it lies inside the page.
+     * @param offset the byte offset within the page; offset + 4 <= size()
+     * @return the integer value in host byte order
+     */
+    int32_t get_int_unchecked(size_t offset) const {
+        uint32_t raw;
+        std::memcpy(&raw, data() + offset, sizeof(raw));
+        return static_cast<int32_t>(order_ == NATIVE_ORDER ? raw : __builtin_bswap32(raw));
+    }
+
+    /**
+     * Writes a 32-bit integer without checking that it lies inside the page.
+     * @param offset the byte offset within the page; offset + 4 <= size()
+     * @param val the integer value to write
+     */
+    void set_int_unchecked(size_t offset, int32_t val) {
+        uint32_t raw = static_cast<uint32_t>(val);
+        if (order_ != NATIVE_ORDER) raw = __builtin_bswap32(raw);
+        if (view_.load(std::memory_order_acquire) != nullptr) materialize();
+        std::memcpy(bb_.get() + offset, &raw, sizeof(raw));
+    }
 
     /**
      * Reads a byte array from the specified offset.
@@ -75,6 +155,15 @@ public:
      */
     std::string get_string(size_t offset) const;
 
+    /**
+     * Reads a string from the specified offset without copying it.
+     * The view points into the page and is valid until the page is
+     * modified, re-read, destroyed, or pointed at another region.
+     * @param offset the byte offset within the page
+     * @return a view of the string bytes
+     */
+    std::string_view get_string_view(size_t offset) const;
+
     /**
      * Writes a string to the specified offset.
      * Strings are stored as byte arrays with UTF-8 encoding.
@@ -96,17 +185,89 @@ public:
     size_t size() const;
 
     /**
-     * Direct access to the underlying byte buffer (for I/O operations).
-     * Use with caution.
+     * Direct access to the underlying bytes (for I/O operations).
+     * Use with caution. The non-const overload returns writable storage,
+     * copying the viewed region into the page first if necessary.
      */
-    std::vector<uint8_t>& contents();
-    const std::vector<uint8_t>& contents() const;
+    uint8_t* contents();
+    const uint8_t* contents() const;
+
+    /**
+     * Points the page at an external read-only region of size() bytes.
+     * The region must outlive the page or the next set_view()/clear_view().
+     *
+     * @param region the first byte of the region
+     */
+    void set_view(const uint8_t* region);
+
+    /**
+     * Stops viewing an external region without copying it. The page's
+     * own storage (whatever it held before) becomes visible again.
+     * Used by callers that are about to overwrite the whole page.
+     */
+    void clear_view();
+
+    /**
+     * Returns true if the page currently reads from an external region.
+     */
+    bool is_view() const;
+
+    /**
+     * Returns the byte order of integers in this page.
+     */
+    ByteOrder byte_order() const;
+
+    /**
+     * Changes how the page's bytes are interpreted. The bytes themselves
+     * are not converted. FileMgr stamps every page it reads with the
+     * database's byte order.
+     */
+    void set_byte_order(ByteOrder order);
+
+    /**
+     * The host's byte order.
+     */
+    static constexpr ByteOrder NATIVE_ORDER =
+        __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? ByteOrder::LittleEndian : ByteOrder::BigEndian;
+
+    /**
+     * Returns the alignment used for the owned storage of a page of the
+     * given size.
+     */
+    static size_t alignment_for(size_t size);
 
 private:
-    std::vector<uint8_t> bb_;  // byte buffer
+    struct FreeDeleter {
+        FreeDeleter() : owned(true) {}
+        explicit FreeDeleter(bool owned) : owned(owned) {}
+        void operator()(uint8_t* p) const;
+        bool owned;  // false for caller-owned storage
+    };
+
+    std::unique_ptr<uint8_t, FreeDeleter> bb_;   // aligned byte buffer, usually owned
+    size_t size_;
+    std::atomic<const uint8_t*> view_{nullptr};  // external read-only region, if any
+    ByteOrder order_;
+
+    // Allocates zeroed, aligned storage of the given size
+    static uint8_t* allocate(size_t size);
+
+    // Current bytes for reading: the view if set, otherwise bb_
+    const uint8_t* data() const {
+        const uint8_t* view = view_.load(std::memory_order_acquire);
+        return view != nullptr ? view : bb_.get();
+    }
+
+    // Copies the viewed region into bb_ before a modification; only the
+    // first of several racing callers copies
+    void materialize();
 
     // Helper to check bounds
-    void check_bounds(size_t offset, size_t size) const;
+    void check_bounds(size_t offset, size_t size) const {
+        if (offset + size > size_) {
+            throw std::out_of_range("Page access out of bounds");
+        }
+    }
 };
 
 } // namespace file
@@ -5,14 +5,37 @@
 #include "file/page.hpp"
 #include "file/filemgr.hpp"
 #include "log/logiterator.hpp"
+#include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
+#include <condition_variable>
 #include <cstdint>
+#include <exception>
 #include <mutex>
 
 namespace log {
 
+/**
+ * Construction-time settings for LogMgr.
+ */
+struct LogMgrOptions {
+    size_t buffer_bytes = 4 << 20;  // log buffer ring, in whole blocks (at least 2)
+    size_t group_max = 64;          // committers the flusher gathers before writing
+    uint64_t group_wait_us = 0;     // longest the flusher waits to gather them; 0 = no wait
+};
+
+/**
+ * Counters describing how flush() requests were served.
+ */
+struct LogStats {
+    size_t flush_requests = 0;  // flush() calls whose LSN was not yet saved
+    size_t group_flushes = 0;   // writes + syncs issued for flush() requests
+    size_t ring_waits = 0;      // block rollovers that waited for a free buffer block
+    size_t drained_blocks = 0;  // closed blocks written before anything waited for them
+};
+
 /**
  * LogMgr manages the write-ahead log (WAL) for the database.
  *
@@ -26,8 +49,27 @@ namespace log {
  *
  * Corresponds to LogMgr in Rust (NMDB2/src/log/logmgr.rs)
  *
- * Thread Safety: This class is NOT thread-safe. Callers must
- * synchronize access (typically via mutex in Transaction layer).
+ * Log buffer: the tail of the log is kept in a ring of in-memory blocks
+ * (LogMgrOptions::buffer_bytes, several MB by default). append()
+ * reserves its LSN and its bytes in the current block with one
+ * compare-and-swap on a word packing the latest LSN and the bytes used,
+ * copies the record while other appenders copy theirs, and marks it
+ * copied. Only the appender whose record does not fit takes the mutex,
+ * to close the block and start the next one; it waits only if that ring
+ * block has not been written out yet, i.e. when the whole ring is full.
+ *
+ * Flusher: a background thread does all log I/O. It drains closed blocks
+ * in the background, in runs of a sixteenth of the ring written with one
+ * vectored write each, once all their records are copied. For flush()
+ * requests it also writes the copied part of the current block, followed
+ * by one sync (group commit: it may first wait up to group_wait_us for
+ * group_max committers), and flush() waits on a condition variable until
+ * the durable LSN reaches its target. The boundary of a block is only
+ * filled in on the copy that is written.
+ *
+ * Thread Safety: append(), flush() and iterator() may be called from any
+ * thread, so one LogMgr can be shared by concurrent transactions and by
+ * BufferMgr flushing pages on their behalf.
  */
 class LogMgr {
 public:
@@ -38,8 +80,19 @@ public:
      *
      * @param fm the file manager
      * @param logfile the name of the log file
+     * @param options the log buffer size and group commit limits
+     * @throws std::invalid_argument if the block size is 1 MB or more
      */
-    LogMgr(std::shared_ptr<file::FileMgr> fm, const std::string& logfile);
+    LogMgr(std::shared_ptr<file::FileMgr> fm, const std::string& logfile,
+           const LogMgrOptions& options = {});
+
+    /**
+     * Writes and syncs everything appended, then stops the flusher.
+     */
+    ~LogMgr();
+
+    LogMgr(const LogMgr&) = delete;
+    LogMgr& operator=(const LogMgr&) = delete;
 
     /**
      * Appends a log record to the log.
@@ -47,18 +100,36 @@ public:
      *
      * @param logrec the log record as a byte vector
      * @return the LSN (Log Sequence Number) of the appended record
+     * @throws std::invalid_argument if the record does not fit in a block
      */
     size_t append(const std::vector<uint8_t>& logrec);
 
     /**
      * Flushes the log to disk if the specified LSN has not been saved yet.
      * This ensures write-ahead logging: log records are on disk before
-     * corresponding data pages.
+     * corresponding data pages. Waits for the flusher, which serves
+     * concurrent callers with one write and sync.
      *
      * @param lsn the log sequence number to flush
+     * @throws std::runtime_error (or the I/O error) if the flusher failed
      */
     void flush(size_t lsn);
 
+    /**
+     * Returns the highest LSN known to be synced to disk.
+     */
+    size_t durable_lsn() const;
+
+    /**
+     * Returns the number of blocks in the log buffer ring.
+     */
+    size_t buffer_blocks() const { return ring_.size(); }
+
+    /**
+     * Returns the flush counters since construction.
+     */
+    LogStats stats() const;
+
     /**
      * Creates an iterator to read log records backward from most recent.
      * The log is flushed before creating the iterator.
@@ -68,32 +139,93 @@ public:
     std::unique_ptr<LogIterator> iterator();
 
 private:
+    /**
+     * One block of the log buffer ring.
+     */
+    struct LogBlock {
+        file::Page page;
+        size_t first_lsn = 0;   // LSN of the first record appended here
+        size_t last_lsn = 0;    // once closed: LSN of the last record
+        size_t final_used = 0;  // once closed: bytes used by records
+        std::unique_ptr<std::atomic<uint64_t>[]> copied;  // one bit per record
+
+        LogBlock(size_t blocksize, file::ByteOrder order, size_t words);
+    };
+
+    // reserve_ packs the latest LSN above the bytes used in the current block
+    static constexpr unsigned USED_BITS = 20;
+    static constexpr uint64_t USED_MASK = (uint64_t{1} << USED_BITS) - 1;
+    static constexpr uint64_t ROLLING = USED_MASK;  // used field while a rollover runs
+
+    // The flusher drains closed blocks once this fraction of the ring is closed
+    static constexpr size_t DRAIN_FRACTION = 16;
+
     std::shared_ptr<file::FileMgr> fm_;
     std::string logfile_;
-    file::Page logpage_;
-    file::BlockId currentblk_;
-    size_t latest_lsn_;
-    size_t last_saved_lsn_;
+    size_t blocksize_;
+    size_t usable_;  // bytes for records in a block, after the boundary
+    LogMgrOptions options_;
+    std::vector<std::unique_ptr<LogBlock>> ring_;
+    size_t drain_blocks_;              // closed blocks that wake the flusher
+    std::atomic<uint64_t> reserve_;    // (latest LSN << USED_BITS) | used bytes
+    std::atomic<int32_t> current_;     // block that appends reserve in
+    file::Page flushpage_;             // flusher's copy of the current block
+
+    mutable std::mutex mutex_;   // guards the members below
+    int32_t closed_through_;     // last closed block
+    int32_t next_to_write_;      // first block that may still change
+    int32_t written_block_;      // last block written to the file
+    size_t durable_lsn_ = 0;     // every record up to here is synced
+    size_t requested_lsn_ = 0;   // highest LSN asked for by flush()
+    size_t waiting_ = 0;         // committers in flush()
+    bool space_wanted_ = false;  // a rollover waits for a ring block
+    bool stopping_ = false;
+    std::exception_ptr error_;   // the flusher's I/O failure, if any
+    LogStats stats_;
+    std::condition_variable work_;     // flusher: a request, rollover or drain is waiting
+    std::condition_variable flushed_;  // durable_lsn_ advanced or the flusher failed
+    std::condition_variable space_;    // ring blocks were written
+    std::condition_variable rolled_;   // a rollover finished
+    std::thread flusher_;
+
+    LogBlock& slot(int32_t blknum) const {
+        return *ring_[static_cast<size_t>(blknum) % ring_.size()];
+    }
+
+    /**
+     * Copies a reserved record into its block and marks it copied.
+     */
+    void copy_record(int32_t blknum, size_t used, size_t lsn, const std::vector<uint8_t>& logrec);
+
+    /**
+     * Closes the current block, whose reservation word was seen as
+     * observed, and reserves recsize bytes at the start of the next one.
+     * Returns false, without changes, if another append got there first.
+     */
+    bool roll_over(uint64_t observed, size_t recsize, size_t& lsn, int32_t& blknum);
+
+    /**
+     * Waits until the reservation word is not ROLLING and returns it.
+     */
+    uint64_t wait_for_rollover();
 
     /**
-     * Allocates a new log block and formats it.
-     * @return the new block identifier
+     * Waits until records [first_lsn, last_lsn] of a block are copied.
      */
-    file::BlockId append_new_block();
+    static void wait_copied(const LogBlock& blk, size_t last_lsn);
 
     /**
-     * Writes the current log page to disk.
+     * Returns true if enough closed blocks wait to be drained.
+     * The caller holds mutex_.
      */
-    void flush_impl();
+    bool drain_due() const {
+        return closed_through_ - next_to_write_ + 1 >= static_cast<int32_t>(drain_blocks_);
+    }
 
     /**
-     * Helper function to append a new block and format it.
+     * Body of the flusher thread.
      */
-    static file::BlockId append_new_block_helper(
-        file::FileMgr* fm,
-        file::Page& logpage,
-        const std::string& logfile
-    );
+    void flusher_loop();
 };
 
 } // namespace log
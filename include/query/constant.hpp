@@ -3,6 +3,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <variant>
 
 class Constant {
@@ -13,6 +14,7 @@ public:
     // Constructors
     static Constant with_int(int ival);
     static Constant with_string(const std::string& sval);
+    static Constant with_string(std::string&& sval);
 
     // Getters
     std::optional<int> as_int() const;
@@ -26,9 +28,20 @@ public:
     bool operator>(const Constant& other) const;
     bool operator>=(const Constant& other) const;
 
+    // Comparison against a string field read with Scan::get_string_view(),
+    // without building a Constant. An int Constant never equals a string
+    // and orders before it, as in the Constant comparisons above.
+    bool operator==(std::string_view sval) const;
+    bool operator!=(std::string_view sval) const;
+    bool operator<(std::string_view sval) const;
+    bool operator>(std::string_view sval) const;
+
     // Hash support
     size_t hash() const;
 
+    // Hash of a string value; equals with_string(sval).hash()
+    static size_t hash(std::string_view sval);
+
     // String representation
     std::string to_string() const;
 
@@ -2,6 +2,7 @@
 #define SCAN_HPP
 
 #include <string>
+#include <string_view>
 #include "query/constant.hpp"
 
 // Forward declarations for error types
@@ -44,6 +45,15 @@ public:
      */
     virtual std::string get_string(const std::string& fldname) = 0;
 
+    /**
+     * Returns the value of the specified string field in the current record
+     * without copying it. The view is only valid until the scan moves to
+     * another record or is closed; copy it to keep it longer.
+     * @param fldname the name of the field
+     * @return a view of the field's string value
+     */
+    virtual std::string_view get_string_view(const std::string& fldname) = 0;
+
     /**
      * Returns the value of the specified field in the current record,
      * expressed as a Constant.
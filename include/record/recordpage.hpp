@@ -7,9 +7,29 @@
 #include <memory>
 #include <optional>
 #include <cstdint>
+#include <stdexcept>
+#include <string_view>
 
 namespace record {
 
+/**
+ * Exception thrown when a writer modified a page while string views into
+ * it were in use on a read-only scan.
+ */
+class StaleViewException : public std::runtime_error {
+public:
+    StaleViewException()
+        : std::runtime_error("Stale view: page modified while a string view was in use") {}
+};
+
+/**
+ * How a RecordPage (or TableScan) will use its pages.
+ */
+enum class PageAccess {
+    Read,  // reads only; modifications throw std::logic_error
+    Write  // reads and modifications
+};
+
 /**
  * RecordPage manages records within a single page.
  *
@@ -18,6 +38,12 @@ namespace record {
  *
  * Flag: 0 = EMPTY, 1 = USED
  *
+ * Concurrency: reads never latch the buffer. Each one runs through
+ * Buffer::read_optimistic() and is retried if a writer changed the page
+ * meanwhile. Each modification holds the buffer's exclusive frame latch,
+ * so the searching and marking of insert_after() is one step for other
+ * writers. A page opened with PageAccess::Read rejects modifications.
+ *
  * NOTE: Phase 4 version does NOT use Transaction layer (Phase 5).
  * Instead, directly uses Buffer for simplicity.
  *
@@ -30,8 +56,10 @@ public:
      *
      * @param buff the buffer containing the page
      * @param layout the record layout
+     * @param access whether the page may be modified
      */
-    RecordPage(buffer::Buffer& buff, const Layout& layout);
+    RecordPage(buffer::Buffer& buff, const Layout& layout,
+               PageAccess access = PageAccess::Write);
 
     /**
      * Gets an integer field value.
@@ -51,6 +79,21 @@ public:
      */
     std::string get_string(size_t slot, const std::string& fldname);
 
+    /**
+     * Gets a string field value without copying it.
+     * The view points into the buffer and is valid while the buffer stays
+     * pinned to this block and no writer latches the frame. On a page
+     * opened with PageAccess::Read, the frame version the view was read
+     * at is remembered, and release_views() reports whether a writer has
+     * latched the frame since. On a PageAccess::Write page, the view is
+     * only safe while no other writer can latch the frame.
+     *
+     * @param slot the slot number
+     * @param fldname the field name
+     * @return a view of the string value
+     */
+    std::string_view get_string_view(size_t slot, const std::string& fldname);
+
     /**
      * Sets an integer field value.
      *
@@ -104,6 +147,20 @@ public:
      */
     const file::BlockId& block() const;
 
+    /**
+     * Returns how the page may be used.
+     */
+    PageAccess access() const;
+
+    /**
+     * Ends the lifetime of the string views taken from this page.
+     *
+     * @return false if a writer latched the frame while views taken on a
+     *         PageAccess::Read page were in use, i.e. they may have
+     *         seen modified bytes
+     */
+    bool release_views();
+
 private:
     enum class Flag : int32_t {
         EMPTY = 0,
@@ -120,6 +177,11 @@ private:
      */
     Flag get_flag(size_t slot);
 
+    /**
+     * Throws std::logic_error if the page was opened for reading.
+     */
+    void check_writable() const;
+
     /**
      * Searches for a slot with the given flag.
      */
@@ -138,6 +200,8 @@ private:
 private:
     buffer::Buffer& buff_;
     Layout layout_;
+    PageAccess access_;
+    std::optional<uint64_t> view_version_;  // frame version of the oldest unreleased view (Read only)
 };
 
 } // namespace record
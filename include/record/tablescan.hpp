@@ -19,6 +19,24 @@ namespace record {
  * Implements the Scan interface for reading records.
  * Provides additional methods for updates (insert, delete, set).
  *
+ * Tables longer than a quarter of the buffer pool (when the scan is
+ * created) are read through a private BufferRing, so a full scan recycles
+ * a few buffers instead of evicting the rest of the pool.
+ *
+ * A scan created with PageAccess::Read only reads: its pages never take
+ * the frame latch (see RecordPage), its update operations throw
+ * std::logic_error, and it does not create the table's first block.
+ *
+ * String views: a view from get_string_view() is valid until the scan
+ * next moves (next(), before_first(), move_to_rid()) or is closed. A
+ * Read scan does not hold writers off meanwhile; instead, next() checks
+ * that no writer latched the page since the current record's views were
+ * taken, and throws StaleViewException if one did (without moving), so
+ * that a result computed from a view that may have changed is not
+ * silently accepted.
+ * On a Write scan, a view is only safe while no other writer modifies
+ * the page.
+ *
  * NOTE: Phase 4 version simplified - no Transaction layer yet.
  * Directly uses BufferMgr.
  *
@@ -32,16 +50,19 @@ public:
      * @param bm the buffer manager
      * @param tablename the table name
      * @param layout the table layout
+     * @param access whether the scan will modify the table
      */
     TableScan(std::shared_ptr<buffer::BufferMgr> bm,
               const std::string& tablename,
-              const Layout& layout);
+              const Layout& layout,
+              PageAccess access = PageAccess::Write);
 
     // Scan interface implementation
     void before_first() override;
     bool next() override;
     int get_int(const std::string& fldname) override;
     std::string get_string(const std::string& fldname) override;
+    std::string_view get_string_view(const std::string& fldname) override;
     Constant get_val(const std::string& fldname) override;
     bool has_field(const std::string& fldname) const override;
     void close() override;
@@ -88,7 +109,38 @@ public:
      */
     void move_to_rid(const RID& rid);
 
+    /**
+     * Returns whether sequential reads go through a private buffer ring.
+     */
+    bool uses_ring() const;
+
 private:
+    /**
+     * A table longer than num_buffers / RING_SCAN_FRACTION blocks is
+     * scanned through a ring.
+     */
+    static constexpr size_t RING_SCAN_FRACTION = 4;
+
+    /**
+     * Ring size for large scans, further limited to an eighth of the pool.
+     */
+    static constexpr size_t RING_BUFFERS = 32;
+
+    /**
+     * Maximum number of blocks in one read run during a scan.
+     */
+    static constexpr size_t READ_RUN_BLOCKS = 16;
+
+    /**
+     * Keeps the blocks after blknum on their way into the buffer pool.
+     * If blknum itself was not requested yet, a run starting there is
+     * loaded with a single read. While less than a run is requested ahead
+     * of blknum, the next run is hinted to BufferMgr::prefetch(), so its
+     * read overlaps with processing the current one. A run is at most a
+     * quarter of the available buffers, or of the ring when there is one.
+     */
+    void load_ahead(int32_t blknum);
+
     /**
      * Moves to a specific block.
      */
@@ -107,10 +159,14 @@ private:
 private:
     std::shared_ptr<buffer::BufferMgr> bm_;
     Layout layout_;
-    std::unique_ptr<RecordPage> rp_;
+    PageAccess access_;
+    std::unique_ptr<RecordPage> rp_;  // null for a read-only scan of an empty table
     std::string filename_;
+    file::FileId file_id_;  // interned filename_, so BlockIds are built without a lookup
     std::optional<size_t> currentslot_;
     std::optional<size_t> current_buffer_idx_;
+    std::unique_ptr<buffer::BufferRing> ring_;  // set for large tables
+    int32_t requested_to_ = 0;  // end of the blocks loaded or prefetched by load_ahead()
 };
 
 } // namespace record
@@ -1,4 +1,5 @@
 #include "buffer/buffer.hpp"
+#include "buffer/buffermgr.hpp"
 
 namespace buffer {
 
@@ -6,7 +7,19 @@ Buffer::Buffer(std::shared_ptr<file::FileMgr> fm,
                std::shared_ptr<log::LogMgr> lm)
     : fm_(fm),
       lm_(lm),
-      contents_(fm->block_size()),
+      contents_(fm->block_size(), fm->byte_order()),
+      blk_(std::nullopt),
+      pins_(0),
+      txnum_(std::nullopt),
+      lsn_(std::nullopt) {
+}
+
+Buffer::Buffer(std::shared_ptr<file::FileMgr> fm,
+               std::shared_ptr<log::LogMgr> lm,
+               uint8_t* frame)
+    : fm_(fm),
+      lm_(lm),
+      contents_(frame, fm->block_size(), fm->byte_order()),
       blk_(std::nullopt),
       pins_(0),
       txnum_(std::nullopt),
@@ -22,28 +35,60 @@ const std::optional<file::BlockId>& Buffer::block() const {
 }
 
 void Buffer::set_modified(size_t txnum, std::optional<size_t> lsn) {
+    if (owner_ != nullptr && txnum_ != txnum) {
+        owner_->note_dirty(txnum, index_);
+    }
     txnum_ = txnum;
     if (lsn.has_value()) {
         lsn_ = lsn;
     }
+    modifications_.fetch_add(1, std::memory_order_acq_rel);
 }
 
 bool Buffer::is_pinned() const {
-    return pins_ > 0;
+    return pins_.load(std::memory_order_acquire) > 0;
 }
 
 std::optional<size_t> Buffer::modifying_tx() const {
     return txnum_;
 }
 
+uint64_t Buffer::modification_count() const {
+    return modifications_.load(std::memory_order_acquire);
+}
+
+void Buffer::latch_exclusive() {
+    for (int spins = 0;; spins++) {
+        uint64_t v = version_.load(std::memory_order_relaxed);
+        if ((v & 1) == 0 &&
+            version_.compare_exchange_weak(v, v + 1, std::memory_order_acquire)) {
+            // Readers that see a modification made below must also see
+            // the odd version when they validate
+            std::atomic_thread_fence(std::memory_order_release);
+            return;
+        }
+        if (spins >= 64) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void Buffer::unlatch_exclusive() {
+    version_.fetch_add(1, std::memory_order_release);
+}
+
 void Buffer::assign_to_block(const file::BlockId& blk) {
+    assign_to_block_unread(blk);
+    fm_->read(blk, contents_);
+}
+
+void Buffer::assign_to_block_unread(const file::BlockId& blk) {
     // Flush old block if dirty
     flush();
 
     // Assign to new block
     blk_ = blk;
-    fm_->read(blk, contents_);
-    pins_ = 0;
+    pins_.store(0, std::memory_order_relaxed);
 }
 
 void Buffer::flush() {
@@ -64,12 +109,36 @@ void Buffer::flush() {
     }
 }
 
+std::optional<size_t> Buffer::modifying_lsn() const {
+    return lsn_;
+}
+
+file::IoHandle Buffer::flush_async(file::Page& copy) {
+    if (!txnum_.has_value() || !blk_.has_value()) {
+        return file::IoHandle();
+    }
+    {
+        FrameWriteLatch latch(*this);
+        copy = contents_;
+    }
+    return fm_->write_async(blk_.value(), copy);
+}
+
+void Buffer::finish_flush() {
+    txnum_ = std::nullopt;
+}
+
+void Buffer::attach(BufferMgr* owner, size_t idx) {
+    owner_ = owner;
+    index_ = idx;
+}
+
 void Buffer::pin() {
-    pins_++;
+    pins_.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void Buffer::unpin() {
-    pins_--;
+    pins_.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 } // namespace buffer
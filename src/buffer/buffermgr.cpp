@@ -1,57 +1,477 @@
 #include "buffer/buffermgr.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
 
 namespace buffer {
 
+namespace {
+
+// Resident set file: magic, version, the file names, then one entry per
+// block (file name index, block number, warmth). Host byte order.
+constexpr char WARM_MAGIC[8] = {'M', 'U', 'D', 'O', 'P', 'W', 'R', 'M'};
+constexpr uint32_t WARM_VERSION = 1;
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool get(const std::string& in, size_t& pos, T& value) {
+    if (in.size() - pos < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value, in.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+} // namespace
+
 BufferMgr::BufferMgr(std::shared_ptr<file::FileMgr> fm,
                      std::shared_ptr<log::LogMgr> lm,
-                     size_t numbuffs)
+                     size_t numbuffs,
+                     const BufferMgrOptions& options)
     : fm_(fm),
-      num_available_(numbuffs),
-      max_time_(MAX_TIME) {
-    bufferpool_.reserve(numbuffs);
+      lm_(lm),
+      policy_kind_(options.policy),
+      max_time_(MAX_TIME),
+      prefetched_(numbuffs, 0),
+      readahead_max_(options.readahead_max),
+      writer_batch_(std::max<size_t>(options.writer_batch, 1)),
+      writer_interval_(options.writer_interval_ms),
+      warm_file_(options.warm_file),
+      warm_interval_(options.warm_save_interval_ms) {
+    if (options.frame_memory != FrameMemory::Heap) {
+        arena_ = std::make_unique<FrameArena>(numbuffs, fm->block_size(), options.frame_memory);
+    }
     for (size_t i = 0; i < numbuffs; i++) {
-        bufferpool_.emplace_back(fm, lm);
+        if (arena_) {
+            bufferpool_.emplace_back(fm, lm, arena_->frame(i));
+        } else {
+            bufferpool_.emplace_back(fm, lm);
+        }
+        bufferpool_.back().attach(this, i);
+    }
+
+    // Split the indices as evenly as possible; no partition is empty
+    size_t nparts = std::clamp<size_t>(options.partitions, 1, std::max<size_t>(numbuffs, 1));
+    partition_index_.resize(numbuffs);
+    partitions_.reserve(nparts);
+    for (size_t p = 0; p < nparts; p++) {
+        auto part = std::make_unique<Partition>();
+        part->index = p;
+        part->first = p * numbuffs / nparts;
+        part->size = (p + 1) * numbuffs / nparts - part->first;
+        part->page_table.reserve(part->size);
+        part->policy = make_replacement_policy(options.policy, part->size);
+        part->num_available.store(part->size, std::memory_order_relaxed);
+        std::fill_n(partition_index_.begin() + static_cast<std::ptrdiff_t>(part->first),
+                    part->size, static_cast<uint32_t>(p));
+        partitions_.push_back(std::move(part));
+    }
+
+    if (options.background_writer && numbuffs > 0) {
+        writer_started_ = std::chrono::steady_clock::now();
+        writer_ = std::thread(&BufferMgr::writer_loop, this);
+    }
+
+    if (!warm_file_.empty() && numbuffs > 0) {
+        restoring_ = true;
+        warm_ = std::thread(&BufferMgr::warm_loop, this);
+    }
+}
+
+BufferMgr::~BufferMgr() {
+    if (writer_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            writer_stop_ = true;
+        }
+        writer_cv_.notify_one();
+        writer_.join();
+    }
+    if (warm_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(warm_mutex_);
+            warm_stop_ = true;
+        }
+        warm_cv_.notify_all();
+        warm_.join();
+    }
+
+    // Reads still in flight target the pages about to be destroyed
+    for (auto& part : partitions_) {
+        std::lock_guard<std::mutex> lock(part->latch);
+        while (!part->in_flight.empty()) {
+            finish_read(*part, part->in_flight.begin()->first);
+        }
+    }
+
+    if (!warm_file_.empty() && !bufferpool_.empty()) {
+        try {
+            save_resident(warm_file_);
+        } catch (const std::runtime_error&) {
+            // Only costs a cold start next time
+        }
     }
 }
 
 size_t BufferMgr::available() const {
-    return num_available_;
+    size_t total = 0;
+    for (const auto& part : partitions_) {
+        total += part->num_available.load(std::memory_order_relaxed);
+    }
+    return total;
 }
 
 void BufferMgr::flush_all(size_t txnum) {
-    for (auto& buff : bufferpool_) {
+    std::vector<size_t> frames;
+    {
+        DirtyStripe& stripe = dirty_[txnum % DIRTY_STRIPES];
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        auto it = stripe.txns.find(txnum);
+        if (it != stripe.txns.end()) {
+            frames.swap(it->second);
+            stripe.txns.erase(it);
+        }
+    }
+    std::sort(frames.begin(), frames.end());
+    frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+
+    // Only the frames still dirty for txnum and the log they depend on
+    // are gathered under the latches; the log flush and the page writes
+    // run without them, so pins in the same partitions are not held up.
+    // The transaction's locks keep others from modifying these pages
+    // until the commit is done.
+    struct Write {
+        size_t idx;
+        file::BlockId blk;
+        file::Page copy;
+        file::IoHandle handle;
+    };
+    std::deque<Write> writes;
+    std::optional<size_t> max_lsn;
+    for (size_t idx : frames) {
+        Partition& part = partition_at(idx);
+        std::lock_guard<std::mutex> lock(part.latch);
+        Buffer& buff = bufferpool_[idx];
         auto tx = buff.modifying_tx();
-        if (tx.has_value() && tx.value() == txnum) {
-            buff.flush();
+        if (!tx.has_value() || tx.value() != txnum || !buff.block().has_value()) {
+            continue;  // cleaned, or taken over by another transaction
+        }
+        auto lsn = buff.modifying_lsn();
+        if (lsn.has_value() && (!max_lsn.has_value() || lsn.value() > max_lsn.value())) {
+            max_lsn = lsn;
         }
+        writes.push_back(Write{idx, buff.block().value(), file::Page(0), file::IoHandle()});
+    }
+
+    // WAL: one log flush covers every page below
+    if (max_lsn.has_value()) {
+        lm_->flush(max_lsn.value());
+    }
+
+    // Each page is copied and submitted under its partition latch; the
+    // frame may have been evicted (and so written) meanwhile
+    std::unordered_set<std::string> files;
+    bool started = false;
+    for (auto& w : writes) {
+        Partition& part = partition_at(w.idx);
+        std::lock_guard<std::mutex> lock(part.latch);
+        Buffer& buff = bufferpool_[w.idx];
+        auto tx = buff.modifying_tx();
+        if (!tx.has_value() || tx.value() != txnum || buff.block() != w.blk) {
+            continue;
+        }
+        auto lsn = buff.modifying_lsn();
+        if (lsn.has_value() && (!max_lsn.has_value() || lsn.value() > max_lsn.value())) {
+            lm_->flush(lsn.value());  // logged after the first pass
+        }
+        files.insert(w.blk.file_name());
+        w.handle = buff.flush_async(w.copy);
+        part.stats.commit_writes++;
+        started = true;
+    }
+
+    // One batch for all the pages. A page whose write failed stays dirty
+    // and goes back on the list, so that a retry writes it again.
+    if (started) {
+        fm_->submit();
+    }
+    std::exception_ptr error;
+    for (auto& w : writes) {
+        try {
+            fm_->wait(w.handle);
+        } catch (const std::runtime_error&) {
+            note_dirty(txnum, w.idx);
+            if (!error) {
+                error = std::current_exception();
+            }
+            continue;
+        }
+        Partition& part = partition_at(w.idx);
+        std::lock_guard<std::mutex> lock(part.latch);
+        Buffer& buff = bufferpool_[w.idx];
+        auto tx = buff.modifying_tx();
+        if (tx.has_value() && tx.value() == txnum && buff.block() == w.blk) {
+            buff.finish_flush();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    // Pages of txnum written earlier by eviction or the background writer
+    {
+        std::lock_guard<std::mutex> lock(unsynced_mutex_);
+        auto it = unsynced_.find(txnum);
+        if (it != unsynced_.end()) {
+            files.insert(it->second.begin(), it->second.end());
+            unsynced_.erase(it);
+        }
+    }
+
+    // One sync per file covers every page written above
+    for (const auto& filename : files) {
+        fm_->sync(filename);
     }
 }
 
-size_t BufferMgr::pin(const file::BlockId& blk) {
-    auto start_time = std::chrono::steady_clock::now();
+size_t BufferMgr::pin(const file::BlockId& blk, BufferRing* ring) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(max_time_.load(std::memory_order_relaxed));
+    Partition& part = partition_of(blk);
+    std::unique_lock<std::mutex> lock(part.latch);
+    reap_reads(part);
+
+    // A free buffer is owed to the queued waiters first
+    std::optional<size_t> idx = try_to_pin(part, blk, part.waiters.empty(), ring);
+    if (idx.has_value()) {
+        lock.unlock();
+        readahead(blk, ring);
+        return idx.value();
+    }
 
-    std::optional<size_t> idx = try_to_pin(blk);
+    // Join the queue. Only its head is signaled, once per freed buffer;
+    // the head can still miss out if a pin of a resident block took it
+    Waiter self;
+    auto pos = part.waiters.insert(part.waiters.end(), &self);
+    part.stats.waits++;
+    while (self.cv.wait_until(lock, deadline, [&self] { return self.signaled; })) {
+        self.signaled = false;
+        idx = try_to_pin(part, blk, true, ring);
+        if (idx.has_value()) {
+            break;
+        }
+    }
+    part.waiters.erase(pos);
 
-    // Wait loop if pool is full
-    while (!idx.has_value() && !waiting_too_long(start_time)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        idx = try_to_pin(blk);
+    // Several buffers may have been freed at once, or this waiter timed
+    // out holding the turn: let the next one try
+    if (part.num_available.load(std::memory_order_relaxed) > 0) {
+        wake_next(part);
     }
 
     if (!idx.has_value()) {
         throw BufferAbortException();
     }
 
+    lock.unlock();
+    readahead(blk, ring);
     return idx.value();
 }
 
+size_t BufferMgr::load_range(const std::string& filename, int32_t first, size_t count,
+                             BufferRing* ring) {
+    return read_run(filename, first, count, ring, RunMode::Load);
+}
+
+size_t BufferMgr::read_run(const std::string& filename, int32_t first, size_t count,
+                           BufferRing* ring, RunMode mode, bool warm) {
+    size_t length = fm_->length(filename);
+    if (first < 0 || static_cast<size_t>(first) >= length) {
+        return 0;
+    }
+    count = std::min(count, length - static_cast<size_t>(first));
+    if (count == 0) {
+        return 0;
+    }
+
+    // Latch every partition the run can touch, in index order so that
+    // concurrent load_range() calls cannot deadlock
+    file::FileId id = fm_->file_id(filename);
+    std::vector<Partition*> parts(count);
+    std::vector<Partition*> ordered;
+    for (size_t i = 0; i < count; i++) {
+        parts[i] = &partition_of(file::BlockId(id, first + static_cast<int32_t>(i)));
+        ordered.push_back(parts[i]);
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const Partition* a, const Partition* b) {
+        return a->first < b->first;
+    });
+    ordered.erase(std::unique(ordered.begin(), ordered.end()), ordered.end());
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(ordered.size());
+    for (Partition* part : ordered) {
+        locks.emplace_back(part->latch);
+    }
+
+    // Stop at the first block that is already resident, and pick distinct
+    // victims for the rest. Each one is held back from its policy while
+    // the others are chosen, so it is not picked twice.
+    std::vector<size_t> frames;
+    frames.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        Partition& part = *parts[i];
+        file::BlockId blk(id, first + static_cast<int32_t>(i));
+        if (!part.waiters.empty() || find_existing_buffer(part, blk)) {
+            break;
+        }
+        std::optional<size_t> idx = mode == RunMode::Restore ? take_free_frame(part)
+                                                             : choose_victim(part, ring, frames);
+        if (!idx.has_value()) {
+            break;
+        }
+        part.policy->pinned(idx.value() - part.first);
+        frames.push_back(idx.value());
+    }
+    size_t run = frames.size();
+    if (run == 0) {
+        return 0;
+    }
+
+    auto read = std::make_shared<RunRead>();
+    std::vector<file::Page*> pages(run);
+    for (size_t i = 0; i < run; i++) {
+        Partition& part = *parts[i];
+        file::BlockId blk(id, first + static_cast<int32_t>(i));
+        assign_buffer(part, frames[i], blk, false);
+        part.policy->loaded(frames[i] - part.first, blk);
+        if (warm) {
+            part.policy->rewarm(frames[i] - part.first);
+        }
+        if (ring != nullptr) {
+            ring_record(part, *ring, frames[i], blk);
+        }
+        // Held back from the policy until finish_read()
+        part.in_flight[frames[i]] = InFlightRead{file::IoHandle(), read};
+        if (mode == RunMode::Prefetch) {
+            prefetched_[frames[i]] = 1;
+            part.stats.prefetches++;
+        }
+        pages[i] = &bufferpool_[frames[i]].contents();
+    }
+    locks.clear();
+
+    std::exception_ptr error;
+    try {
+        fm_->read_range(filename, first, run, pages.data());
+    } catch (...) {
+        error = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> lock(read->mutex);
+        read->ok = !error;
+        read->done.store(true, std::memory_order_release);
+    }
+    read->cv.notify_all();
+
+    // Frames whose pins already waited for the read were finished there.
+    // If the read failed, finish_read() drops the blocks again: the frames
+    // still hold their old contents.
+    for (size_t i = 0; i < run; i++) {
+        Partition& part = *parts[i];
+        std::lock_guard<std::mutex> lock(part.latch);
+        auto it = part.in_flight.find(frames[i]);
+        if (it != part.in_flight.end() && it->second.run == read) {
+            finish_read(part, frames[i]);
+        }
+        if (!error && mode == RunMode::Restore) {
+            part.stats.restored++;
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return run;
+}
+
+size_t BufferMgr::prefetch(const std::string& filename, int32_t first, size_t count,
+                           BufferRing* ring) {
+    size_t length = fm_->length(filename);
+    if (first < 0 || static_cast<size_t>(first) >= length) {
+        return 0;
+    }
+    count = std::min(count, length - static_cast<size_t>(first));
+    size_t budget = available() / 2;
+
+    // Reads on the pread backend complete at submission, in this thread;
+    // one vectored read per run is cheaper than a read per block
+    if (fm_->io_backend() == file::IoBackendKind::Pread) {
+        size_t started = 0;
+        size_t i = 0;
+        while (i < count && started < budget) {
+            size_t run = read_run(filename, first + static_cast<int32_t>(i),
+                                  std::min(count - i, budget - started), ring,
+                                  RunMode::Prefetch);
+            started += run;
+            i += run + 1;  // past the block that ended the run
+        }
+        return started;
+    }
+
+    file::FileId id = fm_->file_id(filename);
+    size_t started = 0;
+    for (size_t i = 0; i < count && started < budget; i++) {
+        file::BlockId blk(id, first + static_cast<int32_t>(i));
+        Partition& part = partition_of(blk);
+        std::lock_guard<std::mutex> lock(part.latch);
+        reap_reads(part);
+        if (!part.waiters.empty() || find_existing_buffer(part, blk)) {
+            continue;
+        }
+        std::optional<size_t> idx = choose_victim(part, ring, {});
+        if (!idx.has_value()) {
+            continue;
+        }
+
+        // Held back from the policy until finish_read()
+        size_t local = idx.value() - part.first;
+        part.policy->pinned(local);
+        assign_buffer(part, idx.value(), blk, false);
+        part.policy->loaded(local, blk);
+        if (ring != nullptr) {
+            ring_record(part, *ring, idx.value(), blk);
+        }
+        part.in_flight[idx.value()] =
+            InFlightRead{fm_->read_async(blk, bufferpool_[idx.value()].contents()), nullptr};
+        prefetched_[idx.value()] = 1;
+        part.stats.prefetches++;
+        started++;
+    }
+    if (started > 0) {
+        fm_->submit();
+    }
+    return started;
+}
+
 void BufferMgr::unpin(size_t idx) {
+    Partition& part = partition_at(idx);
+    std::lock_guard<std::mutex> lock(part.latch);
     Buffer& buff = bufferpool_[idx];
     buff.unpin();
 
     if (!buff.is_pinned()) {
-        num_available_++;
-        // In multi-threaded version, would notify waiting threads here
+        part.num_available.fetch_add(1, std::memory_order_relaxed);
+        part.policy->unpinned(idx - part.first);
+        wake_next(part);
     }
 }
 
@@ -60,31 +480,246 @@ Buffer& BufferMgr::buffer(size_t idx) {
 }
 
 void BufferMgr::set_max_time(uint64_t max_time_ms) {
-    max_time_ = max_time_ms;
+    max_time_.store(max_time_ms, std::memory_order_relaxed);
+}
+
+size_t BufferMgr::save_resident(const std::string& path) {
+    struct Entry {
+        file::BlockId blk;
+        uint8_t warmth;
+    };
+    std::vector<Entry> entries;
+    for (auto& part : partitions_) {
+        std::lock_guard<std::mutex> lock(part->latch);
+        for (const auto& [blk, idx] : part->page_table) {
+            if (part->in_flight.count(idx) == 0) {
+                entries.push_back(Entry{blk, part->policy->warmth(idx - part->first)});
+            }
+        }
+    }
+
+    // File ids are only stable within a process; names are saved instead
+    std::unordered_map<file::FileId, uint32_t> file_index;
+    std::vector<std::string> names;
+    std::string body;
+    for (const Entry& e : entries) {
+        auto [it, added] = file_index.emplace(e.blk.file_id(),
+                                              static_cast<uint32_t>(names.size()));
+        if (added) {
+            names.push_back(e.blk.file_name());
+        }
+        put(body, it->second);
+        put(body, e.blk.number());
+        put(body, e.warmth);
+    }
+    std::string out(WARM_MAGIC, sizeof(WARM_MAGIC));
+    put(out, WARM_VERSION);
+    put(out, static_cast<uint32_t>(names.size()));
+    for (const std::string& name : names) {
+        put(out, static_cast<uint32_t>(name.size()));
+        out += name;
+    }
+    put(out, static_cast<uint64_t>(entries.size()));
+    out += body;
+
+    // Written aside and renamed, so a crash leaves the old set or the new
+    std::lock_guard<std::mutex> lock(save_mutex_);
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        f.write(out.data(), static_cast<std::streamsize>(out.size()));
+        if (!f) {
+            throw std::runtime_error("Cannot write resident set: " + tmp);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        throw std::runtime_error("Cannot write resident set: " + path + ": " + ec.message());
+    }
+    return entries.size();
+}
+
+size_t BufferMgr::restore_resident(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+        return 0;
+    }
+    std::string in((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    size_t pos = sizeof(WARM_MAGIC);
+    uint32_t version = 0;
+    uint32_t nfiles = 0;
+    if (in.size() < pos || std::memcmp(in.data(), WARM_MAGIC, pos) != 0 ||
+        !get(in, pos, version) || version != WARM_VERSION || !get(in, pos, nfiles)) {
+        return 0;
+    }
+    std::vector<std::string> names;
+    for (uint32_t i = 0; i < nfiles; i++) {
+        uint32_t len = 0;
+        if (!get(in, pos, len) || in.size() - pos < len) {
+            return 0;
+        }
+        names.emplace_back(in, pos, len);
+        pos += len;
+    }
+
+    struct Entry {
+        uint32_t file;
+        int32_t block;
+        uint8_t warmth;
+    };
+    uint64_t nentries = 0;
+    if (!get(in, pos, nentries)) {
+        return 0;
+    }
+    std::vector<Entry> entries;
+    for (uint64_t i = 0; i < nentries; i++) {
+        Entry e{};
+        if (!get(in, pos, e.file) || !get(in, pos, e.block) || !get(in, pos, e.warmth) ||
+            e.file >= names.size()) {
+            return 0;
+        }
+        entries.push_back(e);
+    }
+
+    // Warm blocks first, then runs of consecutive blocks of each file
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.warmth != b.warmth) return a.warmth > b.warmth;
+        if (a.file != b.file) return a.file < b.file;
+        return a.block < b.block;
+    });
+    std::vector<uint8_t> present(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        present[i] = fm_->exists(names[i]);
+    }
+
+    size_t loaded = 0;
+    for (size_t start = 0; start < entries.size() && !warm_stopping(); start += RESTORE_BATCH) {
+        size_t end = std::min(start + RESTORE_BATCH, entries.size());
+        size_t i = start;
+        while (i < end) {
+            const Entry& e = entries[i];
+            if (!present[e.file]) {
+                i++;
+                continue;
+            }
+            size_t len = 1;
+            while (i + len < end && entries[i + len].file == e.file &&
+                   entries[i + len].warmth == e.warmth &&
+                   entries[i + len].block == e.block + static_cast<int32_t>(len)) {
+                len++;
+            }
+            size_t n = read_run(names[e.file], e.block, len, nullptr, RunMode::Restore,
+                                e.warmth != 0);
+            loaded += n;
+            // A short run stopped at a block that is resident, past the end
+            // of the file, or has no free frame: skip it
+            i += n < len ? n + 1 : len;
+        }
+    }
+    return loaded;
+}
+
+void BufferMgr::wait_for_restore() {
+    std::unique_lock<std::mutex> lock(warm_mutex_);
+    warm_cv_.wait(lock, [this] { return !restoring_; });
+}
+
+BufferStats BufferMgr::stats() const {
+    BufferStats total;
+    for (const auto& part : partitions_) {
+        std::lock_guard<std::mutex> lock(part->latch);
+        total.hits += part->stats.hits;
+        total.misses += part->stats.misses;
+        total.waits += part->stats.waits;
+        total.clean_evictions += part->stats.clean_evictions;
+        total.dirty_evictions += part->stats.dirty_evictions;
+        total.background_writes += part->stats.background_writes;
+        total.ring_reuses += part->stats.ring_reuses;
+        total.prefetches += part->stats.prefetches;
+        total.prefetch_hits += part->stats.prefetch_hits;
+        total.commit_writes += part->stats.commit_writes;
+        total.restored += part->stats.restored;
+    }
+    return total;
+}
+
+double BufferMgr::writer_rate() const {
+    if (!writer_.joinable()) {
+        return 0.0;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                   writer_started_).count();
+    return seconds > 0 ? static_cast<double>(stats().background_writes) / seconds : 0.0;
+}
+
+ReplacementKind BufferMgr::replacement_policy() const {
+    return policy_kind_;
+}
+
+size_t BufferMgr::num_partitions() const {
+    return partitions_.size();
+}
+
+size_t BufferMgr::num_buffers() const {
+    return bufferpool_.size();
+}
+
+FrameMemory BufferMgr::frame_memory() const {
+    return arena_ ? arena_->memory() : FrameMemory::Heap;
 }
 
 std::shared_ptr<file::FileMgr> BufferMgr::file_mgr() const {
     return fm_;
 }
 
-std::optional<size_t> BufferMgr::try_to_pin(const file::BlockId& blk) {
+BufferMgr::Partition& BufferMgr::partition_of(const file::BlockId& blk) {
+    return *partitions_[std::hash<file::BlockId>{}(blk) % partitions_.size()];
+}
+
+BufferMgr::Partition& BufferMgr::partition_at(size_t idx) {
+    return *partitions_[partition_index_[idx]];
+}
+
+std::optional<size_t> BufferMgr::try_to_pin(Partition& part, const file::BlockId& blk,
+                                            bool may_evict, BufferRing* ring) {
     // First, check if block already in pool
-    std::optional<size_t> idx = find_existing_buffer(blk);
+    std::optional<size_t> idx = find_existing_buffer(part, blk);
+    if (idx.has_value() && !finish_read(part, idx.value())) {
+        idx = std::nullopt;  // the prefetch failed; read it again below
+    }
 
     // If not found, allocate a new buffer
-    if (!idx.has_value()) {
-        idx = choose_unpinned_buffer();
+    if (idx.has_value()) {
+        part.stats.hits++;
+        if (prefetched_[idx.value()]) {
+            part.stats.prefetch_hits++;
+            prefetched_[idx.value()] = 0;
+        }
+        part.policy->accessed(idx.value() - part.first);
+    } else if (!may_evict) {
+        return std::nullopt;
+    } else {
+        idx = choose_victim(part, ring, {});
         if (idx.has_value()) {
-            bufferpool_[idx.value()].assign_to_block(blk);
+            assign_buffer(part, idx.value(), blk, true);
+            part.stats.misses++;
+            part.policy->loaded(idx.value() - part.first, blk);
+            if (ring != nullptr) {
+                ring_record(part, *ring, idx.value(), blk);
+            }
         } else {
-            return std::nullopt;  // Pool is full
+            return std::nullopt;  // Partition is full
         }
     }
 
     // Increment pin count
     if (idx.has_value()) {
         if (!bufferpool_[idx.value()].is_pinned()) {
-            num_available_--;  // Transitioning from unpinned to pinned
+            // Transitioning from unpinned to pinned
+            part.num_available.fetch_sub(1, std::memory_order_relaxed);
+            part.policy->pinned(idx.value() - part.first);
         }
         bufferpool_[idx.value()].pin();
     }
@@ -92,30 +727,355 @@ std::optional<size_t> BufferMgr::try_to_pin(const file::BlockId& blk) {
     return idx;
 }
 
-std::optional<size_t> BufferMgr::find_existing_buffer(const file::BlockId& blk) {
-    for (size_t i = 0; i < bufferpool_.size(); i++) {
-        const auto& block_opt = bufferpool_[i].block();
-        if (block_opt.has_value() && block_opt.value() == blk) {
-            return i;
+void BufferMgr::wake_next(Partition& part) {
+    if (!part.waiters.empty()) {
+        Waiter* head = part.waiters.front();
+        head->signaled = true;
+        head->cv.notify_one();
+    }
+}
+
+std::optional<size_t> BufferMgr::find_existing_buffer(Partition& part,
+                                                      const file::BlockId& blk) {
+    auto it = part.page_table.find(blk);
+    if (it == part.page_table.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void BufferMgr::assign_buffer(Partition& part, size_t idx, const file::BlockId& blk,
+                              bool read) {
+    Buffer& buff = bufferpool_[idx];
+    prefetched_[idx] = 0;
+
+    // Evict the old block from the page table
+    if (buff.block().has_value()) {
+        auto it = part.page_table.find(buff.block().value());
+        if (it != part.page_table.end() && it->second == idx) {
+            part.page_table.erase(it);
+        }
+
+        // The assignment below writes a dirty old page back
+        auto tx = buff.modifying_tx();
+        if (tx.has_value()) {
+            part.stats.dirty_evictions++;
+            note_unsynced(tx.value(), buff.block()->file_name());
+        } else {
+            part.stats.clean_evictions++;
+        }
+    }
+
+    if (read) {
+        buff.assign_to_block(blk);
+    } else {
+        buff.assign_to_block_unread(blk);
+    }
+
+    // Only published once the contents are in place; if the read threw,
+    // the block is simply not resident. Without read, the caller reads
+    // later and drops the block itself if that read fails.
+    part.page_table[blk] = idx;
+}
+
+void BufferMgr::note_unsynced(size_t txnum, const std::string& filename) {
+    std::lock_guard<std::mutex> lock(unsynced_mutex_);
+    unsynced_[txnum].insert(filename);
+}
+
+void BufferMgr::note_dirty(size_t txnum, size_t idx) {
+    DirtyStripe& stripe = dirty_[txnum % DIRTY_STRIPES];
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    stripe.txns[txnum].push_back(idx);
+}
+
+void BufferMgr::writer_loop() {
+    std::unique_lock<std::mutex> lock(writer_mutex_);
+    while (!writer_cv_.wait_for(lock, writer_interval_, [this] { return writer_stop_; })) {
+        lock.unlock();
+        write_round();
+        lock.lock();
+    }
+}
+
+void BufferMgr::write_round() {
+    // The pages are chosen and pinned under their partition latches; the
+    // log flush and the writes run without them. The pin keeps a frame
+    // from being evicted, and so written again, while its write is out.
+    struct Write {
+        size_t idx;
+        file::BlockId blk;
+        size_t txnum;
+        uint64_t modifications;
+        file::Page copy;
+        file::IoHandle handle;
+    };
+    std::deque<Write> writes;
+    std::optional<size_t> max_lsn;
+    for (size_t scanned = 0; scanned < bufferpool_.size() && writes.size() < writer_batch_;
+         scanned++) {
+        size_t idx = writer_cursor_;
+        writer_cursor_ = (writer_cursor_ + 1) % bufferpool_.size();
+
+        // Cheap unlatched checks first; rechecked under the latch
+        Buffer& buff = bufferpool_[idx];
+        if (buff.is_pinned()) {
+            continue;
+        }
+        Partition& part = partition_at(idx);
+        std::lock_guard<std::mutex> lock(part.latch);
+        auto tx = buff.modifying_tx();
+        if (buff.is_pinned() || !tx.has_value() || !buff.block().has_value() ||
+            part.in_flight.count(idx) > 0) {
+            continue;
+        }
+        part.num_available.fetch_sub(1, std::memory_order_relaxed);
+        part.policy->pinned(idx - part.first);
+        buff.pin();
+        auto lsn = buff.modifying_lsn();
+        if (lsn.has_value() && (!max_lsn.has_value() || lsn.value() > max_lsn.value())) {
+            max_lsn = lsn;
+        }
+        note_unsynced(tx.value(), buff.block()->file_name());
+        writes.push_back(Write{idx, buff.block().value(), tx.value(), 0,
+                               file::Page(0), file::IoHandle()});
+    }
+    if (writes.empty()) {
+        return;
+    }
+
+    // A failure leaves the pages dirty for a later round or an eviction
+    bool ok = true;
+    try {
+        if (max_lsn.has_value()) {
+            lm_->flush(max_lsn.value());
+        }
+        for (auto& w : writes) {
+            Buffer& buff = bufferpool_[w.idx];
+            w.modifications = buff.modification_count();
+            auto lsn = buff.modifying_lsn();
+            if (lsn.has_value() && lsn.value() > max_lsn.value_or(0)) {
+                lm_->flush(lsn.value());  // logged by a pinner meanwhile
+            }
+            w.handle = buff.flush_async(w.copy);
+        }
+        fm_->submit();
+    } catch (const std::runtime_error&) {
+        ok = false;
+    }
+
+    for (auto& w : writes) {
+        bool written = ok;
+        if (written) {
+            try {
+                fm_->wait(w.handle);
+            } catch (const std::runtime_error&) {
+                written = false;
+            }
+        }
+        {
+            // Clean only if nobody modified the page since it was copied
+            Partition& part = partition_at(w.idx);
+            std::lock_guard<std::mutex> lock(part.latch);
+            Buffer& buff = bufferpool_[w.idx];
+            auto tx = buff.modifying_tx();
+            if (written && tx.has_value() && tx.value() == w.txnum &&
+                buff.block() == w.blk && buff.modification_count() == w.modifications) {
+                buff.finish_flush();
+                part.stats.background_writes++;
+            }
+        }
+        unpin(w.idx);
+    }
+}
+
+void BufferMgr::warm_loop() {
+    try {
+        restore_resident(warm_file_);
+    } catch (const std::runtime_error&) {
+        // A failed read ends the reload early; the pool just stays colder
+    }
+
+    std::unique_lock<std::mutex> lock(warm_mutex_);
+    restoring_ = false;
+    warm_cv_.notify_all();
+    if (warm_interval_.count() == 0) {
+        return;
+    }
+    while (!warm_cv_.wait_for(lock, warm_interval_, [this] { return warm_stop_; })) {
+        lock.unlock();
+        try {
+            save_resident(warm_file_);
+        } catch (const std::runtime_error&) {
+            // Try again next time
+        }
+        lock.lock();
+    }
+}
+
+bool BufferMgr::warm_stopping() {
+    std::lock_guard<std::mutex> lock(warm_mutex_);
+    return warm_stop_;
+}
+
+std::optional<size_t> BufferMgr::take_free_frame(Partition& part) {
+    while (part.free_cursor < part.size) {
+        size_t idx = part.first + part.free_cursor++;
+        if (!bufferpool_[idx].block().has_value()) {
+            return idx;
         }
     }
     return std::nullopt;
 }
 
-std::optional<size_t> BufferMgr::choose_unpinned_buffer() {
-    for (size_t i = 0; i < bufferpool_.size(); i++) {
-        if (!bufferpool_[i].is_pinned()) {
-            return i;
+std::optional<size_t> BufferMgr::choose_victim(Partition& part, BufferRing* ring,
+                                               const std::vector<size_t>& taken) {
+    if (ring != nullptr) {
+        if (ring->slots_.size() != partitions_.size()) {
+            ring->slots_.resize(partitions_.size());
+        }
+        // The ring grows from the pool until it holds its share, then
+        // recycles, oldest first. A slot whose buffer was pinned or reused
+        // by someone else is dropped: the page is no longer the scan's alone.
+        auto& slots = ring->slots_[part.index];
+        while (slots.size() >= ring_share(*ring)) {
+            BufferRing::Slot slot = slots.front();
+            slots.pop_front();
+            const Buffer& buff = bufferpool_[slot.frame];
+            if (buff.is_pinned() || buff.block() != slot.blk) {
+                continue;
+            }
+            // Rotated to the back; ring_record() then updates its block
+            slots.push_back(slot);
+            if (std::find(taken.begin(), taken.end(), slot.frame) != taken.end()) {
+                break;  // every usable slot is already in this load_range()
+            }
+            finish_read(part, slot.frame);  // a prefetch the scan never used
+            part.stats.ring_reuses++;
+            return slot.frame;
         }
     }
-    return std::nullopt;  // All buffers are pinned
+
+    // Buffers with prefetch reads in flight are held back; if they are
+    // all that is left, wait for one
+    std::optional<size_t> idx = choose_unpinned_buffer(part);
+    while (!idx.has_value() && !part.in_flight.empty()) {
+        finish_read(part, part.in_flight.begin()->first);
+        idx = choose_unpinned_buffer(part);
+    }
+    return idx;
 }
 
-bool BufferMgr::waiting_too_long(
-    const std::chrono::steady_clock::time_point& start_time) const {
-    auto elapsed = std::chrono::steady_clock::now() - start_time;
-    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
-    return static_cast<uint64_t>(elapsed_ms) > max_time_;
+void BufferMgr::ring_record(Partition& part, BufferRing& ring, size_t idx,
+                            const file::BlockId& blk) {
+    auto& slots = ring.slots_[part.index];
+    auto it = std::find_if(slots.begin(), slots.end(),
+                           [idx](const BufferRing::Slot& s) { return s.frame == idx; });
+    if (it != slots.end()) {
+        slots.erase(it);
+    } else if (slots.size() >= ring_share(ring)) {
+        return;
+    }
+    slots.push_back(BufferRing::Slot{idx, blk});
+}
+
+bool BufferMgr::finish_read(Partition& part, size_t idx) {
+    auto it = part.in_flight.find(idx);
+    if (it == part.in_flight.end()) {
+        return true;
+    }
+    InFlightRead read = std::move(it->second);
+    part.in_flight.erase(it);
+    part.policy->unpinned(idx - part.first);
+
+    // A run read completes without the partition latch, so it can be
+    // waited for here while holding it
+    bool ok = true;
+    if (read.run) {
+        std::unique_lock<std::mutex> lock(read.run->mutex);
+        read.run->cv.wait(lock, [&read] { return read.run->done.load(); });
+        ok = read.run->ok;
+    } else {
+        try {
+            fm_->wait(read.handle);
+        } catch (const std::runtime_error&) {
+            ok = false;
+        }
+    }
+    if (ok) {
+        return true;
+    }
+
+    // Leave the block out of the pool; a later pin reads it again
+    const auto& blk = bufferpool_[idx].block();
+    if (blk.has_value()) {
+        auto entry = part.page_table.find(blk.value());
+        if (entry != part.page_table.end() && entry->second == idx) {
+            part.page_table.erase(entry);
+        }
+    }
+    prefetched_[idx] = 0;
+    return false;
+}
+
+void BufferMgr::reap_reads(Partition& part) {
+    for (auto it = part.in_flight.begin(); it != part.in_flight.end();) {
+        size_t idx = it->first;
+        bool done = it->second.done();
+        ++it;
+        if (done) {
+            finish_read(part, idx);
+        }
+    }
+}
+
+void BufferMgr::readahead(const file::BlockId& blk, BufferRing* ring) {
+    if (readahead_max_ == 0) {
+        return;
+    }
+
+    int32_t from = 0;
+    size_t count = 0;
+    {
+        ReadaheadStripe& stripe = readahead_[blk.file_id() % READAHEAD_STRIPES];
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        ReadaheadState& state = stripe.files[blk.file_id()];
+        int32_t b = blk.number();
+        if (b == state.next) {
+            state.window = std::clamp<size_t>(state.window, READAHEAD_MIN, readahead_max_);
+            // Refill once less than half a window is left ahead of the reader
+            if (static_cast<int64_t>(state.ahead_end) - b <=
+                static_cast<int64_t>(state.window / 2)) {
+                from = std::max(state.ahead_end, b + 1);
+                count = state.window;
+                if (ring != nullptr) {
+                    count = std::min(count, std::max<size_t>(1, ring->capacity() / 2));
+                }
+                state.ahead_end = from + static_cast<int32_t>(count);
+                state.window = std::min(state.window * 2, readahead_max_);
+            }
+        } else {
+            state.window /= 2;
+            state.ahead_end = b + 1;
+        }
+        state.next = b + 1;
+    }
+
+    if (count > 0) {
+        prefetch(blk.file_name(), from, count, ring);
+    }
+}
+
+size_t BufferMgr::ring_share(const BufferRing& ring) const {
+    return (ring.capacity_ + partitions_.size() - 1) / partitions_.size();
+}
+
+std::optional<size_t> BufferMgr::choose_unpinned_buffer(Partition& part) {
+    std::optional<size_t> local = part.policy->victim();
+    if (!local.has_value()) {
+        return std::nullopt;
+    }
+    return part.first + local.value();
 }
 
 } // namespace buffer
@@ -0,0 +1,76 @@
+#include "buffer/framearena.hpp"
+#include "file/page.hpp"
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+
+namespace buffer {
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = 2 << 20;  // the default huge page size on x86-64 and arm64
+
+size_t round_up(size_t n, size_t multiple) {
+    return (n + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+FrameArena::FrameArena(size_t frames, size_t frame_size, FrameMemory memory)
+    : frames_(frames),
+      stride_(round_up(frame_size, file::Page::alignment_for(frame_size))),
+      memory_(memory) {
+    if (frames == 0) {
+        return;
+    }
+
+    void* addr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (memory == FrameMemory::HugeTlb) {
+        bytes_ = round_up(frames * stride_, HUGE_PAGE_SIZE);
+        addr = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+    if (addr == MAP_FAILED) {
+        if (memory_ == FrameMemory::HugeTlb) {
+            memory_ = FrameMemory::HugePages;
+        }
+        // Huge pages can only back huge-page-aligned ranges: map one extra
+        // huge page and trim the ends
+        bool huge = memory_ == FrameMemory::HugePages;
+        bytes_ = huge ? round_up(frames * stride_, HUGE_PAGE_SIZE) : frames * stride_;
+        size_t slack = huge ? HUGE_PAGE_SIZE : 0;
+        addr = ::mmap(nullptr, bytes_ + slack, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        if (huge) {
+            auto start = reinterpret_cast<uintptr_t>(addr);
+            uintptr_t aligned = round_up(start, HUGE_PAGE_SIZE);
+            if (aligned > start) {
+                ::munmap(addr, aligned - start);
+            }
+            if (start + slack > aligned) {
+                ::munmap(reinterpret_cast<void*>(aligned + bytes_), start + slack - aligned);
+            }
+            addr = reinterpret_cast<void*>(aligned);
+        }
+#ifdef MADV_HUGEPAGE
+        // Only a hint; fails harmlessly where THP is compiled out
+        if (memory_ == FrameMemory::HugePages) {
+            ::madvise(addr, bytes_, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    base_ = static_cast<uint8_t*>(addr);
+}
+
+FrameArena::~FrameArena() {
+    if (base_ != nullptr) {
+        ::munmap(base_, bytes_);
+    }
+}
+
+} // namespace buffer
@@ -0,0 +1,313 @@
+#include "buffer/replacementpolicy.hpp"
+#include <algorithm>
+#include <list>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace buffer {
+
+namespace {
+
+/**
+ * The original policy: the lowest-numbered unpinned frame.
+ */
+class NaivePolicy : public ReplacementPolicy {
+public:
+    explicit NaivePolicy(size_t num_frames) {
+        for (size_t i = 0; i < num_frames; i++) {
+            evictable_.insert(evictable_.end(), i);
+        }
+    }
+
+    void loaded(size_t, const file::BlockId&) override {}
+    void accessed(size_t) override {}
+    void pinned(size_t frame) override { evictable_.erase(frame); }
+    void unpinned(size_t frame) override { evictable_.insert(frame); }
+
+    std::optional<size_t> victim() override {
+        if (evictable_.empty()) {
+            return std::nullopt;
+        }
+        return *evictable_.begin();
+    }
+
+    ReplacementKind kind() const override { return ReplacementKind::Naive; }
+
+private:
+    std::set<size_t> evictable_;
+};
+
+/**
+ * Second-chance clock. Every access sets the frame's reference bit; the
+ * hand clears set bits as it passes and stops at the first unpinned frame
+ * whose bit is already clear.
+ */
+class ClockPolicy : public ReplacementPolicy {
+public:
+    explicit ClockPolicy(size_t num_frames)
+        : referenced_(num_frames, 0), evictable_(num_frames, 1), num_evictable_(num_frames) {}
+
+    void loaded(size_t frame, const file::BlockId&) override { referenced_[frame] = 1; }
+    void accessed(size_t frame) override { referenced_[frame] = 1; }
+    uint8_t warmth(size_t frame) const override { return referenced_[frame]; }
+
+    void pinned(size_t frame) override {
+        if (evictable_[frame]) {
+            evictable_[frame] = 0;
+            num_evictable_--;
+        }
+    }
+
+    void unpinned(size_t frame) override {
+        if (!evictable_[frame]) {
+            evictable_[frame] = 1;
+            num_evictable_++;
+        }
+    }
+
+    std::optional<size_t> victim() override {
+        if (num_evictable_ == 0) {
+            return std::nullopt;
+        }
+        // At most two sweeps: the first may only clear reference bits
+        while (true) {
+            size_t frame = hand_;
+            hand_ = (hand_ + 1) % referenced_.size();
+            if (!evictable_[frame]) {
+                continue;
+            }
+            if (referenced_[frame]) {
+                referenced_[frame] = 0;
+                continue;
+            }
+            return frame;
+        }
+    }
+
+    ReplacementKind kind() const override { return ReplacementKind::Clock; }
+
+private:
+    std::vector<uint8_t> referenced_;
+    std::vector<uint8_t> evictable_;
+    size_t num_evictable_;
+    size_t hand_ = 0;
+};
+
+/**
+ * LRU-K with K = 2. The victim is the unpinned frame whose second-most-
+ * recent access is oldest; frames accessed only once since they were
+ * loaded count as infinitely old and go first, oldest single access
+ * first. This keeps one-off scans from flushing frequently used pages.
+ * History starts over when a frame is loaded with a new block.
+ */
+class LruKPolicy : public ReplacementPolicy {
+public:
+    explicit LruKPolicy(size_t num_frames)
+        : last_(num_frames, 0), previous_(num_frames, 0), evictable_(num_frames, 1) {
+        for (size_t i = 0; i < num_frames; i++) {
+            queue_.insert(key(i));
+        }
+    }
+
+    void loaded(size_t frame, const file::BlockId&) override {
+        update(frame, [this, frame] {
+            previous_[frame] = 0;
+            last_[frame] = ++clock_;
+        });
+    }
+
+    void accessed(size_t frame) override {
+        update(frame, [this, frame] {
+            previous_[frame] = last_[frame];
+            last_[frame] = ++clock_;
+        });
+    }
+
+    uint8_t warmth(size_t frame) const override { return previous_[frame] != 0 ? 1 : 0; }
+
+    void pinned(size_t frame) override {
+        if (evictable_[frame]) {
+            queue_.erase(key(frame));
+            evictable_[frame] = 0;
+        }
+    }
+
+    void unpinned(size_t frame) override {
+        if (!evictable_[frame]) {
+            queue_.insert(key(frame));
+            evictable_[frame] = 1;
+        }
+    }
+
+    std::optional<size_t> victim() override {
+        if (queue_.empty()) {
+            return std::nullopt;
+        }
+        return std::get<2>(*queue_.begin());
+    }
+
+    ReplacementKind kind() const override { return ReplacementKind::LruK; }
+
+private:
+    // (second-most-recent access, most recent access, frame); 0 = never
+    using Key = std::tuple<uint64_t, uint64_t, size_t>;
+
+    Key key(size_t frame) const { return Key(previous_[frame], last_[frame], frame); }
+
+    // Applies a history change, keeping the frame's queue position in sync
+    template <typename Change>
+    void update(size_t frame, Change change) {
+        if (evictable_[frame]) {
+            queue_.erase(key(frame));
+        }
+        change();
+        if (evictable_[frame]) {
+            queue_.insert(key(frame));
+        }
+    }
+
+    std::vector<uint64_t> last_;
+    std::vector<uint64_t> previous_;
+    std::vector<uint8_t> evictable_;
+    std::set<Key> queue_;  // evictable frames, best victim first
+    uint64_t clock_ = 0;
+};
+
+/**
+ * Full 2Q. Newly loaded blocks enter the A1in FIFO. Blocks evicted from
+ * A1in are remembered (by BlockId only) in the A1out ghost list; a block
+ * that is loaded again while still remembered goes straight to the Am LRU
+ * queue. A1in is the eviction source while it is over a quarter of the
+ * pool, which lets a scan pass through without disturbing Am.
+ */
+class TwoQPolicy : public ReplacementPolicy {
+public:
+    explicit TwoQPolicy(size_t num_frames)
+        : kin_(std::max<size_t>(1, num_frames / 4)),
+          kout_(std::max<size_t>(1, num_frames / 2)),
+          where_(num_frames, Queue::Free),
+          pos_(num_frames),
+          blocks_(num_frames),
+          evictable_(num_frames, 1) {
+        for (size_t i = 0; i < num_frames; i++) {
+            pos_[i] = free_.insert(free_.end(), i);
+        }
+    }
+
+    void loaded(size_t frame, const file::BlockId& blk) override {
+        if (where_[frame] == Queue::A1in && blocks_[frame].has_value()) {
+            remember(blocks_[frame].value());
+        }
+        list_of(where_[frame]).erase(pos_[frame]);
+
+        auto ghost = ghosts_.find(blk);
+        if (ghost != ghosts_.end()) {
+            a1out_.erase(ghost->second);
+            ghosts_.erase(ghost);
+            place(frame, Queue::Am);
+        } else {
+            place(frame, Queue::A1in);
+        }
+        blocks_[frame] = blk;
+    }
+
+    void accessed(size_t frame) override {
+        if (where_[frame] == Queue::Am) {
+            am_.splice(am_.end(), am_, pos_[frame]);
+        }
+    }
+
+    uint8_t warmth(size_t frame) const override { return where_[frame] == Queue::Am ? 1 : 0; }
+
+    // As if the block had come back from the ghost list
+    void rewarm(size_t frame) override {
+        if (where_[frame] == Queue::A1in) {
+            a1in_.erase(pos_[frame]);
+            place(frame, Queue::Am);
+        }
+    }
+
+    void pinned(size_t frame) override { evictable_[frame] = 0; }
+    void unpinned(size_t frame) override { evictable_[frame] = 1; }
+
+    std::optional<size_t> victim() override {
+        if (auto f = first_evictable(free_)) return f;
+        if (a1in_.size() > kin_) {
+            if (auto f = first_evictable(a1in_)) return f;
+        }
+        if (auto f = first_evictable(am_)) return f;
+        return first_evictable(a1in_);
+    }
+
+    ReplacementKind kind() const override { return ReplacementKind::TwoQ; }
+
+private:
+    enum class Queue : uint8_t { Free, A1in, Am };
+
+    std::list<size_t>& list_of(Queue q) {
+        switch (q) {
+            case Queue::A1in: return a1in_;
+            case Queue::Am: return am_;
+            default: return free_;
+        }
+    }
+
+    void place(size_t frame, Queue q) {
+        where_[frame] = q;
+        pos_[frame] = list_of(q).insert(list_of(q).end(), frame);
+    }
+
+    void remember(const file::BlockId& blk) {
+        if (ghosts_.count(blk)) {
+            return;
+        }
+        ghosts_[blk] = a1out_.insert(a1out_.end(), blk);
+        if (a1out_.size() > kout_) {
+            ghosts_.erase(a1out_.front());
+            a1out_.pop_front();
+        }
+    }
+
+    // Oldest unpinned frame in a queue; pinned frames are skipped
+    std::optional<size_t> first_evictable(const std::list<size_t>& q) const {
+        for (size_t frame : q) {
+            if (evictable_[frame]) {
+                return frame;
+            }
+        }
+        return std::nullopt;
+    }
+
+    size_t kin_;
+    size_t kout_;
+    std::list<size_t> free_;  // never assigned
+    std::list<size_t> a1in_;  // FIFO, oldest first
+    std::list<size_t> am_;    // LRU, least recent first
+    std::list<file::BlockId> a1out_;  // ghost FIFO, oldest first
+    std::unordered_map<file::BlockId, std::list<file::BlockId>::iterator> ghosts_;
+    std::vector<Queue> where_;
+    std::vector<std::list<size_t>::iterator> pos_;
+    std::vector<std::optional<file::BlockId>> blocks_;
+    std::vector<uint8_t> evictable_;
+};
+
+} // namespace
+
+std::unique_ptr<ReplacementPolicy> make_replacement_policy(ReplacementKind kind,
+                                                           size_t num_frames) {
+    switch (kind) {
+        case ReplacementKind::Clock:
+            return std::make_unique<ClockPolicy>(num_frames);
+        case ReplacementKind::LruK:
+            return std::make_unique<LruKPolicy>(num_frames);
+        case ReplacementKind::TwoQ:
+            return std::make_unique<TwoQPolicy>(num_frames);
+        case ReplacementKind::Naive:
+        default:
+            return std::make_unique<NaivePolicy>(num_frames);
+    }
+}
+
+} // namespace buffer
@@ -1,14 +1,47 @@
 #include "file/filemgr.hpp"
 #include <filesystem>
+#include <fstream>
 #include <stdexcept>
 #include <cstring>
+#include <cerrno>
+#include <vector>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 
 namespace fs = std::filesystem;
 
 namespace file {
 
-FileMgr::FileMgr(const std::string& db_directory, size_t blocksize)
-    : db_directory_(db_directory), blocksize_(blocksize), is_new_(false) {
+namespace {
+
+// Smallest mapping created for a file; mappings grow geometrically from here
+constexpr size_t MIN_MAPPING_BYTES = 1 << 20;
+
+// Number of blocks prefetched ahead of a backward scan
+constexpr int32_t BACKWARD_WINDOW = 16;
+
+// Records the page format of a database directory. Format 1 is big-endian,
+// format 2 little-endian.
+const char* const PAGE_FORMAT_FILE = "mudopdb.format";
+constexpr int PAGE_FORMAT_VERSION = 2;
+
+} // namespace
+
+FileMgr::FileMgr(const std::string& db_directory, size_t blocksize,
+                 const FileMgrOptions& options)
+    : db_directory_(db_directory), blocksize_(blocksize), is_new_(false),
+      mmap_reads_(options.mmap_reads), direct_io_(options.direct_io),
+      extent_blocks_(blocksize > 0 ? options.extent_size / blocksize : 0),
+      temp_sync_(options.temp_sync), log_sync_(options.log_sync),
+      data_sync_(options.data_sync),
+      io_(make_io_backend(options.io_backend, options.io_queue_depth)) {
+
+    if (direct_io_ && mmap_reads_) {
+        throw std::invalid_argument("direct_io and mmap_reads cannot be combined");
+    }
 
     // Check if directory exists
     is_new_ = !fs::exists(db_directory_);
@@ -29,142 +62,601 @@ FileMgr::FileMgr(const std::string& db_directory, size_t blocksize)
             }
         }
     }
+
+    byte_order_ = load_page_format();
+}
+
+ByteOrder FileMgr::load_page_format() {
+    const std::string marker = get_file_path(PAGE_FORMAT_FILE);
+
+    int version = 0;
+    if (fs::exists(marker)) {
+        std::ifstream in(marker);
+        if (!(in >> version) || (version != 1 && version != PAGE_FORMAT_VERSION)) {
+            throw std::runtime_error("Unsupported page format in " + marker);
+        }
+    } else {
+        // A directory that already holds data predates the marker and
+        // therefore uses big-endian pages. Record that so it sticks.
+        bool has_data = false;
+        for (const auto& entry : fs::directory_iterator(db_directory_)) {
+            if (entry.is_regular_file()) {
+                has_data = true;
+                break;
+            }
+        }
+        version = has_data ? 1 : PAGE_FORMAT_VERSION;
+
+        std::ofstream out(marker, std::ios::trunc);
+        out << version << "\n";
+        if (!out) {
+            throw std::runtime_error("Failed to write page format marker: " + marker);
+        }
+    }
+    return version == 1 ? ByteOrder::BigEndian : ByteOrder::LittleEndian;
+}
+
+FileMgr::~FileMgr() {
+    // Outstanding asynchronous requests still reference the descriptors
+    try {
+        io_->wait_all();
+    } catch (...) {
+    }
+    for (auto& entry : open_files_) {
+        for (auto& m : entry.second->mappings) {
+            ::munmap(const_cast<uint8_t*>(m->base), m->len);
+        }
+        ::close(entry.second->fd);
+    }
 }
 
 std::string FileMgr::get_file_path(const std::string& filename) const {
     return db_directory_ + "/" + filename;
 }
 
-std::fstream FileMgr::get_file(const std::string& filename, std::ios::openmode mode) {
+FileMgr::OpenFile& FileMgr::get_file(const std::string& filename) {
+    return get_file(FileRegistry::id_of(filename));
+}
+
+FileMgr::OpenFile& FileMgr::get_file(FileId id) {
+    return *open_entry(id, true);
+}
+
+FileMgr::OpenFile* FileMgr::find_file(const std::string& filename) {
+    return find_file(FileRegistry::id_of(filename));
+}
+
+FileMgr::OpenFile* FileMgr::find_file(FileId id) {
+    return open_entry(id, false);
+}
+
+FileMgr::OpenFile* FileMgr::open_entry(FileId id, bool create) {
+    {
+        std::shared_lock<std::shared_mutex> lock(table_mutex_);
+        auto it = open_files_.find(id);
+        if (it != open_files_.end()) {
+            return it->second.get();
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(table_mutex_);
+
+    // Another thread may have opened the file while we waited
+    auto it = open_files_.find(id);
+    if (it != open_files_.end()) {
+        return it->second.get();
+    }
+
+    const std::string& filename = FileRegistry::name_of(id);
     std::string filepath = get_file_path(filename);
-    std::fstream file(filepath, mode);
+    bool direct = false;
+    int fd = open_file(filepath, create, direct);
+    if (fd < 0) {
+        return nullptr;  // missing, and not to be created
+    }
 
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filepath);
+    // The length is read once here and maintained in memory afterwards
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file: " + filepath +
+                                 " (" + std::strerror(err) + ")");
     }
 
-    return file;
+    auto entry = std::make_unique<OpenFile>(filename, fd, direct,
+                                            static_cast<size_t>(st.st_size) / blocksize_,
+                                            sync_policy(filename));
+    return open_files_.emplace(id, std::move(entry)).first->second.get();
 }
 
-void FileMgr::update_file_size(const std::string& filename) {
-    std::string filepath = get_file_path(filename);
+int FileMgr::open_file(const std::string& filepath, bool create, bool& direct) {
+    const int flags = O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0);
+    direct = false;
+
+    if (direct_io_) {
+        int fd = ::open(filepath.c_str(), flags | O_DIRECT, 0644);
+        if (fd >= 0) {
+            size_t sector = 512;  // assumed when the kernel cannot report it
+            bool supported = true;
+#ifdef STATX_DIOALIGN
+            struct statx stx;
+            if (::statx(fd, "", AT_EMPTY_PATH, STATX_DIOALIGN, &stx) == 0 &&
+                (stx.stx_mask & STATX_DIOALIGN) != 0) {
+                supported = stx.stx_dio_offset_align != 0;
+                sector = stx.stx_dio_offset_align;
+            }
+#endif
+            if (supported) {
+                if (blocksize_ % sector != 0) {
+                    ::close(fd);
+                    throw std::invalid_argument(
+                        "Block size " + std::to_string(blocksize_) +
+                        " is not a multiple of the logical sector size " +
+                        std::to_string(sector) + " required for direct I/O on " + filepath);
+                }
+                direct = true;
+                return fd;
+            }
+            ::close(fd);
+        } else if (errno == ENOENT && !create) {
+            return -1;
+        } else if (errno != EINVAL) {
+            throw std::runtime_error("Failed to open file: " + filepath +
+                                     " (" + std::strerror(errno) + ")");
+        }
+        // O_DIRECT unsupported here: fall through to a buffered open
+    }
+
+    int fd = ::open(filepath.c_str(), flags, 0644);
+    if (fd < 0) {
+        if (errno == ENOENT && !create) {
+            return -1;
+        }
+        throw std::runtime_error("Failed to open file: " + filepath +
+                                 " (" + std::strerror(errno) + ")");
+    }
+    return fd;
+}
+
+void FileMgr::extend_length(OpenFile& f, size_t blocks) {
+    size_t current = f.blocks.load(std::memory_order_acquire);
+    while (current < blocks &&
+           !f.blocks.compare_exchange_weak(current, blocks, std::memory_order_acq_rel)) {
+    }
+}
+
+const uint8_t* FileMgr::mapped_block(OpenFile& f, int32_t blknum) {
+    size_t start = static_cast<size_t>(blknum) * blocksize_;
+    size_t end = start + blocksize_;
+
+    const Mapping* m = f.mapping.load(std::memory_order_acquire);
+    if (m == nullptr || end > m->len) {
+        std::lock_guard<std::mutex> lock(f.map_mutex);
+        m = f.mapping.load(std::memory_order_acquire);
+        if (m == nullptr || end > m->len) {
+            // Grow geometrically so a file that keeps growing is remapped
+            // only a logarithmic number of times
+            size_t len = std::max(end, MIN_MAPPING_BYTES);
+            if (m != nullptr) {
+                len = std::max(len, 2 * m->len);
+            }
 
-    if (fs::exists(filepath)) {
-        size_t file_size = fs::file_size(filepath);
-        open_files_[filename] = file_size / blocksize_;
+            void* addr = ::mmap(nullptr, len, PROT_READ, MAP_SHARED, f.fd, 0);
+            if (addr == MAP_FAILED) {
+                throw std::runtime_error(std::string("Failed to map file: ") + std::strerror(errno));
+            }
+            if (f.hint.load() == AccessHint::Sequential) {
+                ::madvise(addr, len, MADV_SEQUENTIAL);
+            }
+
+            f.mappings.push_back(std::make_unique<Mapping>(
+                Mapping{static_cast<const uint8_t*>(addr), len}));
+            m = f.mappings.back().get();
+            f.mapping.store(m, std::memory_order_release);
+        }
+    }
+    return m->base + start;
+}
+
+void FileMgr::prefetch_backward(OpenFile& f, int32_t blknum) {
+    if (blknum <= 0 || blknum % BACKWARD_WINDOW != 0) {
+        return;
+    }
+    size_t first = static_cast<size_t>(std::max(0, blknum - BACKWARD_WINDOW));
+    size_t start = first * blocksize_;
+    size_t len = (static_cast<size_t>(blknum) - first) * blocksize_;
+
+    const Mapping* m = mmap_reads_ ? f.mapping.load(std::memory_order_acquire) : nullptr;
+    if (m != nullptr) {
+        // madvise needs a page-aligned start address
+        size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t aligned = start - start % page;
+        ::madvise(const_cast<uint8_t*>(m->base) + aligned, len + (start - aligned), MADV_WILLNEED);
     } else {
-        open_files_[filename] = 0;
+        ::posix_fadvise(f.fd, static_cast<off_t>(start), static_cast<off_t>(len),
+                        POSIX_FADV_WILLNEED);
     }
 }
 
 void FileMgr::read(const BlockId& blk, Page& page) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    OpenFile* file = find_file(blk.file_id());
 
-    std::string filepath = get_file_path(blk.file_name());
+    // If the file or block does not exist, page remains unchanged
+    if (file == nullptr ||
+        static_cast<size_t>(blk.number()) >= file->blocks.load(std::memory_order_acquire)) {
+        return;
+    }
+    OpenFile& f = *file;
 
-    // Check if file and block exist
-    if (!fs::exists(filepath)) {
-        // File doesn't exist, page remains zeroed
+    if (f.hint.load(std::memory_order_relaxed) == AccessHint::Reverse) {
+        prefetch_backward(f, blk.number());
+    }
+    page.set_byte_order(byte_order_);
+
+    if (mmap_reads_) {
+        page.set_view(mapped_block(f, blk.number()));
         return;
     }
 
-    std::fstream file = get_file(blk.file_name(), std::ios::in | std::ios::out | std::ios::binary);
+    page.clear_view();
+    off_t pos = static_cast<off_t>(blk.number()) * static_cast<off_t>(blocksize_);
+    if (!pread_full(f.fd, page.contents(), page.size(), pos)) {
+        throw std::runtime_error("Failed to read block: " + blk.to_string());
+    }
+}
 
-    // Calculate position
-    size_t pos = static_cast<size_t>(blk.number()) * blocksize_;
+void FileMgr::read_range(const std::string& filename, int32_t first_blk, size_t count,
+                         Page* pages) {
+    std::vector<Page*> ptrs(count);
+    for (size_t i = 0; i < count; i++) {
+        ptrs[i] = &pages[i];
+    }
+    read_range(filename, first_blk, count, ptrs.data());
+}
 
-    // Get file size
-    file.seekg(0, std::ios::end);
-    size_t file_size = file.tellg();
+void FileMgr::read_range(const std::string& filename, int32_t first_blk, size_t count,
+                         Page* const* pages) {
+    OpenFile* file = find_file(filename);
+    if (file == nullptr) {
+        return;
+    }
+    OpenFile& f = *file;
 
-    // If block is beyond file size, page remains zeroed
-    if (pos + page.contents().size() > file_size) {
+    // Clip the run to the blocks that exist
+    size_t length = f.blocks.load(std::memory_order_acquire);
+    size_t first = static_cast<size_t>(first_blk);
+    if (first >= length) {
         return;
     }
+    count = std::min(count, length - first);
+    for (size_t i = 0; i < count; i++) {
+        pages[i]->set_byte_order(byte_order_);
+    }
 
-    // Seek and read
-    file.seekg(pos, std::ios::beg);
-    file.read(reinterpret_cast<char*>(page.contents().data()), page.contents().size());
+    if (mmap_reads_) {
+        for (size_t i = 0; i < count; i++) {
+            pages[i]->set_view(mapped_block(f, static_cast<int32_t>(first + i)));
+        }
+        return;
+    }
 
-    if (!file) {
-        throw std::runtime_error("Failed to read block: " + blk.to_string());
+    // preadv accepts at most IOV_MAX buffers per call
+    const size_t max_iov = static_cast<size_t>(::sysconf(_SC_IOV_MAX));
+    std::vector<struct iovec> iov(std::min(count, max_iov));
+
+    for (size_t done = 0; done < count; done += iov.size()) {
+        size_t n = std::min(iov.size(), count - done);
+        for (size_t i = 0; i < n; i++) {
+            Page* page = pages[done + i];
+            page->clear_view();
+            iov[i].iov_base = page->contents();
+            iov[i].iov_len = page->size();
+        }
+
+        off_t pos = static_cast<off_t>(first + done) * static_cast<off_t>(blocksize_);
+        if (!preadv_full(f.fd, iov.data(), static_cast<int>(n), pos)) {
+            throw std::runtime_error("Failed to read blocks " + std::to_string(first + done) +
+                                     ".." + std::to_string(first + done + n - 1) +
+                                     " of file: " + filename);
+        }
     }
 }
 
-void FileMgr::write(const BlockId& blk, Page& page) {
-    std::lock_guard<std::mutex> lock(mutex_);
+void FileMgr::write_range(const std::string& filename, int32_t first_blk, size_t count,
+                          Page* const* pages) {
+    OpenFile& f = get_file(filename);
+    for (size_t i = 0; i < count; i++) {
+        check_byte_order(*pages[i]);
+    }
 
-    std::fstream file = get_file(blk.file_name(), std::ios::in | std::ios::out | std::ios::binary);
+    // pwritev accepts at most IOV_MAX buffers per call
+    const size_t max_iov = static_cast<size_t>(::sysconf(_SC_IOV_MAX));
+    std::vector<struct iovec> iov(std::min(count, max_iov));
+    size_t first = static_cast<size_t>(first_blk);
+
+    for (size_t done = 0; done < count; done += iov.size()) {
+        size_t n = std::min(iov.size(), count - done);
+        for (size_t i = 0; i < n; i++) {
+            const Page& page = *pages[done + i];
+            iov[i].iov_base = const_cast<uint8_t*>(page.contents());
+            iov[i].iov_len = page.size();
+        }
+
+        off_t pos = static_cast<off_t>(first + done) * static_cast<off_t>(blocksize_);
+        if (!pwritev_full(f.fd, iov.data(), static_cast<int>(n), pos)) {
+            throw std::runtime_error("Failed to write blocks " + std::to_string(first + done) +
+                                     ".." + std::to_string(first + done + n - 1) +
+                                     " of file: " + filename);
+        }
+    }
 
-    // Calculate position
-    size_t pos = static_cast<size_t>(blk.number()) * blocksize_;
+    if (count > 0) {
+        // Writing past the end extends the file
+        extend_length(f, first + count);
+        note_write(f);
+    }
+}
 
-    // Seek and write
-    file.seekp(pos, std::ios::beg);
-    file.write(reinterpret_cast<const char*>(page.contents().data()), page.contents().size());
+void FileMgr::write(const BlockId& blk, Page& page) {
+    OpenFile& f = get_file(blk.file_id());
+    const Page& src = page;
+    check_byte_order(src);
 
-    if (!file) {
+    off_t pos = static_cast<off_t>(blk.number()) * static_cast<off_t>(blocksize_);
+    if (!pwrite_full(f.fd, src.contents(), src.size(), pos)) {
         throw std::runtime_error("Failed to write block: " + blk.to_string());
     }
 
-    file.flush();
+    // Writing past the end extends the file
+    extend_length(f, (static_cast<size_t>(pos) + src.size()) / blocksize_);
+    note_write(f);
+}
+
+IoHandle FileMgr::read_async(const BlockId& blk, Page& page) {
+    OpenFile* file = find_file(blk.file_id());
+    auto c = std::make_shared<IoCompletion>();
 
-    // Update cached file size
-    update_file_size(blk.file_name());
+    // Missing file or block beyond its end: nothing to read
+    if (file == nullptr ||
+        static_cast<size_t>(blk.number()) >= file->blocks.load(std::memory_order_acquire)) {
+        c->done.store(true, std::memory_order_release);
+        return IoHandle(std::move(c));
+    }
+    OpenFile& f = *file;
+    page.set_byte_order(byte_order_);
+
+    // Mapped reads never block on I/O, so they complete right away
+    if (mmap_reads_) {
+        page.set_view(mapped_block(f, blk.number()));
+        c->done.store(true, std::memory_order_release);
+        return IoHandle(std::move(c));
+    }
+
+    page.clear_view();
+    off_t pos = static_cast<off_t>(blk.number()) * static_cast<off_t>(blocksize_);
+    io_->submit_read(f.fd, page.contents(), page.size(), pos, c);
+    return IoHandle(std::move(c));
 }
 
-BlockId FileMgr::append(const std::string& filename) {
-    std::lock_guard<std::mutex> lock(mutex_);
+IoHandle FileMgr::write_async(const BlockId& blk, Page& page) {
+    OpenFile& f = get_file(blk.file_id());
+    auto c = std::make_shared<IoCompletion>();
+
+    const Page& src = page;
+    check_byte_order(src);
+
+    off_t pos = static_cast<off_t>(blk.number()) * static_cast<off_t>(blocksize_);
+    size_t end_blocks = (static_cast<size_t>(pos) + src.size()) / blocksize_;
+    c->on_complete = [this, &f, end_blocks](const IoCompletion& done) {
+        if (done.ok()) {
+            extend_length(f, end_blocks);
+            // Runs on the reaping thread, so a failed sync cannot throw here;
+            // the file stays dirty and the next sync() reports the error.
+            if (f.sync != SyncPolicy::None) {
+                f.dirty.store(true, std::memory_order_release);
+            }
+            if (f.sync == SyncPolicy::EveryWrite) {
+                sync_file(f);
+            }
+        }
+    };
 
-    // Get current file size
-    size_t new_blknum = length(filename);
+    io_->submit_write(f.fd, src.contents(), src.size(), pos, c);
+    return IoHandle(std::move(c));
+}
 
-    BlockId blk(filename, static_cast<int32_t>(new_blknum));
+void FileMgr::submit() {
+    io_->submit();
+}
 
-    // Create a zero-filled block
-    std::vector<uint8_t> zeros(blocksize_, 0);
+void FileMgr::wait(const IoHandle& handle) {
+    if (!handle.completion_) {
+        return;
+    }
+    const IoCompletion& c = *handle.completion_;
+    io_->wait(c);
 
-    std::fstream file = get_file(filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
+    if (!c.ok()) {
+        std::string reason = c.result < 0 ? std::strerror(static_cast<int>(-c.result))
+                                          : "short transfer";
+        throw std::runtime_error("Asynchronous I/O failed: " + reason);
+    }
+}
 
-    // Seek to the position (should be at end, but explicit is safer)
-    size_t pos = new_blknum * blocksize_;
-    file.seekp(pos, std::ios::beg);
+void FileMgr::wait_all() {
+    io_->wait_all();
+}
+
+IoBackendKind FileMgr::io_backend() const {
+    return io_->kind();
+}
+
+BlockId FileMgr::append(const std::string& filename) {
+    OpenFile& f = get_file(filename);
 
-    // Write zeros
-    file.write(reinterpret_cast<const char*>(zeros.data()), zeros.size());
+    // Only appends to the same file wait on each other
+    std::lock_guard<std::mutex> lock(f.extend_mutex);
+    size_t new_blknum = f.blocks.load(std::memory_order_acquire);
 
-    if (!file) {
-        throw std::runtime_error("Failed to append block to: " + filename);
+    BlockId blk(filename, static_cast<int32_t>(new_blknum));
+    off_t pos = static_cast<off_t>(new_blknum) * static_cast<off_t>(blocksize_);
+    off_t bs = static_cast<off_t>(blocksize_);
+
+    // Reserve the next extent past the end of file without changing its size
+    if (f.can_fallocate && extent_blocks_ > 1 && new_blknum >= f.reserved) {
+        off_t len = static_cast<off_t>(extent_blocks_) * bs;
+        if (::fallocate(f.fd, FALLOC_FL_KEEP_SIZE, pos, len) == 0) {
+            f.reserved = new_blknum + extent_blocks_;
+        } else if (errno == EOPNOTSUPP || errno == ENOSYS) {
+            f.can_fallocate = false;
+        }
     }
 
-    file.flush();
+    // Grow the file by one block. Inside a reserved extent this is only a
+    // size update; the unwritten range reads back as zeros. fallocate never
+    // shrinks the file, so a concurrent write past the end is not lost.
+    bool grown = false;
+    if (f.can_fallocate) {
+        grown = ::fallocate(f.fd, 0, pos, bs) == 0;
+        if (!grown && (errno == EOPNOTSUPP || errno == ENOSYS)) f.can_fallocate = false;
+    }
+    if (!grown) {
+        // Write a zero-filled block (a Page, so it is aligned for O_DIRECT)
+        const Page zeros(blocksize_);
+        if (!pwrite_full(f.fd, zeros.contents(), zeros.size(), pos)) {
+            throw std::runtime_error("Failed to append block to: " + filename);
+        }
+    }
 
-    // Update cached file size
-    open_files_[filename] = new_blknum + 1;
+    extend_length(f, new_blknum + 1);
+    note_write(f);
 
     return blk;
 }
 
 size_t FileMgr::length(const std::string& filename) {
-    // Check cache first
-    auto it = open_files_.find(filename);
-    if (it != open_files_.end()) {
-        return it->second;
+    OpenFile* f = find_file(filename);
+    return f != nullptr ? f->blocks.load(std::memory_order_acquire) : 0;
+}
+
+bool FileMgr::exists(const std::string& filename) const {
+    return fs::exists(get_file_path(filename));
+}
+
+void FileMgr::advise(const std::string& filename, AccessHint hint) {
+    OpenFile* file = find_file(filename);
+    if (file == nullptr) {
+        return;
+    }
+    OpenFile& f = *file;
+    f.hint.store(hint);
+
+    if (mmap_reads_) {
+        std::lock_guard<std::mutex> lock(f.map_mutex);
+        const Mapping* m = f.mapping.load(std::memory_order_acquire);
+        if (m != nullptr) {
+            ::madvise(const_cast<uint8_t*>(m->base), m->len,
+                      hint == AccessHint::Sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+        }
+    } else {
+        ::posix_fadvise(f.fd, 0, 0, hint == AccessHint::Sequential ? POSIX_FADV_SEQUENTIAL
+                                                                   : POSIX_FADV_NORMAL);
     }
+}
 
-    // Not in cache, read from filesystem
-    std::string filepath = get_file_path(filename);
+void FileMgr::sync(const std::string& filename) {
+    OpenFile* file = find_file(filename);
+    if (file == nullptr) {
+        return;  // never written through this FileMgr
+    }
+    OpenFile& f = *file;
+    if (f.dirty.load(std::memory_order_acquire) && !sync_file(f)) {
+        throw std::runtime_error("Failed to sync file: " + filename +
+                                 " (" + std::strerror(errno) + ")");
+    }
+}
 
-    if (!fs::exists(filepath)) {
-        open_files_[filename] = 0;
-        return 0;
+void FileMgr::sync_all() {
+    std::vector<OpenFile*> dirty;
+    {
+        std::shared_lock<std::shared_mutex> lock(table_mutex_);
+        for (auto& entry : open_files_) {
+            if (entry.second->dirty.load(std::memory_order_acquire)) {
+                dirty.push_back(entry.second.get());
+            }
+        }
     }
+    // Entries are never removed from the table, so the pointers stay valid
+    for (OpenFile* f : dirty) {
+        if (!sync_file(*f)) {
+            throw std::runtime_error("Failed to sync file: " + f->name +
+                                     " (" + std::strerror(errno) + ")");
+        }
+    }
+}
 
-    size_t file_size = fs::file_size(filepath);
-    size_t num_blocks = file_size / blocksize_;
+SyncPolicy FileMgr::sync_policy(const std::string& filename) const {
+    static const std::string log_suffix = ".log";
+    if (filename.compare(0, 4, "temp") == 0) {
+        return temp_sync_;
+    }
+    if (filename.size() >= log_suffix.size() &&
+        filename.compare(filename.size() - log_suffix.size(), log_suffix.size(), log_suffix) == 0) {
+        return log_sync_;
+    }
+    return data_sync_;
+}
+
+size_t FileMgr::sync_count() const {
+    return sync_count_.load(std::memory_order_relaxed);
+}
+
+void FileMgr::note_write(OpenFile& f) {
+    switch (f.sync) {
+        case SyncPolicy::None:
+            break;
+        case SyncPolicy::Deferred:
+            f.dirty.store(true, std::memory_order_release);
+            break;
+        case SyncPolicy::EveryWrite:
+            f.dirty.store(true, std::memory_order_release);
+            if (!sync_file(f)) {
+                throw std::runtime_error("Failed to sync file: " + f.name +
+                                         " (" + std::strerror(errno) + ")");
+            }
+            break;
+    }
+}
+
+bool FileMgr::sync_file(OpenFile& f) {
+    // Clear first: a write that lands during fdatasync marks the file again
+    f.dirty.store(false, std::memory_order_release);
+    sync_count_.fetch_add(1, std::memory_order_relaxed);
+    if (::fdatasync(f.fd) != 0) {
+        f.dirty.store(true, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+ByteOrder FileMgr::byte_order() const {
+    return byte_order_;
+}
+
+void FileMgr::check_byte_order(const Page& page) const {
+    if (page.byte_order() != byte_order_) {
+        throw std::invalid_argument("Page byte order does not match the database page format");
+    }
+}
+
+FileId FileMgr::file_id(const std::string& filename) const {
+    return FileRegistry::id_of(filename);
+}
 
-    open_files_[filename] = num_blocks;
-    return num_blocks;
+bool FileMgr::is_direct(const std::string& filename) {
+    OpenFile* f = find_file(filename);
+    return f != nullptr && f->direct;
 }
 
 bool FileMgr::is_new() const {
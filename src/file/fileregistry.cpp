@@ -0,0 +1,58 @@
+#include "file/fileregistry.hpp"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace file {
+
+namespace {
+
+struct Registry {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, FileId> ids;
+    std::deque<std::string> names;  // indexed by id; deque keeps references stable
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+} // namespace
+
+FileId FileRegistry::id_of(const std::string& filename) {
+    Registry& r = registry();
+    {
+        std::shared_lock<std::shared_mutex> lock(r.mutex);
+        auto it = r.ids.find(filename);
+        if (it != r.ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(r.mutex);
+    auto [it, inserted] = r.ids.emplace(filename, static_cast<FileId>(r.names.size()));
+    if (inserted) {
+        r.names.push_back(filename);
+    }
+    return it->second;
+}
+
+const std::string& FileRegistry::name_of(FileId id) {
+    Registry& r = registry();
+    std::shared_lock<std::shared_mutex> lock(r.mutex);
+    if (id >= r.names.size()) {
+        throw std::out_of_range("Unknown file id: " + std::to_string(id));
+    }
+    return r.names[id];
+}
+
+size_t FileRegistry::size() {
+    Registry& r = registry();
+    std::shared_lock<std::shared_mutex> lock(r.mutex);
+    return r.names.size();
+}
+
+} // namespace file
@@ -0,0 +1,460 @@
+#include "file/iobackend.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+namespace file {
+
+bool pread_full(int fd, uint8_t* buf, size_t len, off_t offset) {
+    while (len > 0) {
+        ssize_t n = ::pread(fd, buf, len, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) return false;  // unexpected end of file
+        buf += n;
+        len -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+bool pwrite_full(int fd, const uint8_t* buf, size_t len, off_t offset) {
+    while (len > 0) {
+        ssize_t n = ::pwrite(fd, buf, len, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        buf += n;
+        len -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+bool preadv_full(int fd, struct iovec* iov, int iovcnt, off_t offset) {
+    while (iovcnt > 0) {
+        ssize_t n = ::preadv(fd, iov, iovcnt, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) return false;  // unexpected end of file
+        offset += n;
+
+        // Skip fully transferred buffers, then trim a partially filled one
+        size_t left = static_cast<size_t>(n);
+        while (iovcnt > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+    return true;
+}
+
+bool pwritev_full(int fd, struct iovec* iov, int iovcnt, off_t offset) {
+    while (iovcnt > 0) {
+        ssize_t n = ::pwritev(fd, iov, iovcnt, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        offset += n;
+
+        // Skip fully transferred buffers, then trim a partially written one
+        size_t left = static_cast<size_t>(n);
+        while (iovcnt > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+    return true;
+}
+
+namespace {
+
+void complete(IoCompletion& c, ssize_t result) {
+    c.result = result;
+    if (c.on_complete) {
+        c.on_complete(c);
+    }
+    c.done.store(true, std::memory_order_release);
+}
+
+// ============================================================================
+// PreadBackend: performs each request synchronously at submission
+// ============================================================================
+
+class PreadBackend : public IoBackend {
+public:
+    void submit_read(int fd, uint8_t* buf, size_t len, off_t offset,
+                     std::shared_ptr<IoCompletion> c) override {
+        c->expected = len;
+        bool ok = pread_full(fd, buf, len, offset);
+        complete(*c, ok ? static_cast<ssize_t>(len) : -errno);
+    }
+
+    void submit_write(int fd, const uint8_t* buf, size_t len, off_t offset,
+                      std::shared_ptr<IoCompletion> c) override {
+        c->expected = len;
+        bool ok = pwrite_full(fd, buf, len, offset);
+        complete(*c, ok ? static_cast<ssize_t>(len) : -errno);
+    }
+
+    void submit() override {}
+    void wait(const IoCompletion&) override {}
+    void wait_all() override {}
+
+    IoBackendKind kind() const override {
+        return IoBackendKind::Pread;
+    }
+};
+
+// ============================================================================
+// UringBackend: io_uring via raw system calls (no liburing dependency)
+// ============================================================================
+
+int sys_io_uring_setup(unsigned entries, io_uring_params* p) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                                      flags, nullptr, 0));
+}
+
+int sys_io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+/**
+ * Lock usage: sq_mutex_ guards the submission ring, cq_mutex_ guards the
+ * completion ring, inflight_mutex_ guards the in-flight table. They are
+ * always acquired in that order.
+ *
+ * A request the kernel completes short is finished with pread/pwrite
+ * when its completion is reaped.
+ */
+class UringBackend : public IoBackend {
+public:
+    /**
+     * Sets up a ring, or returns nullptr if io_uring is unavailable or
+     * lacks the read/write opcodes (before 5.6, which also has no probe).
+     */
+    static std::unique_ptr<UringBackend> create(unsigned queue_depth) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        int fd = sys_io_uring_setup(queue_depth, &params);
+        if (fd < 0) {
+            return nullptr;
+        }
+        std::unique_ptr<UringBackend> ring(new UringBackend(fd));
+        if (!ring->supports(IORING_OP_READ) || !ring->supports(IORING_OP_WRITE) ||
+            !ring->map_rings(params)) {
+            return nullptr;
+        }
+        return ring;
+    }
+
+    ~UringBackend() override {
+        try {
+            wait_all();
+        } catch (...) {
+        }
+        if (sqes_ != MAP_FAILED) ::munmap(sqes_, sqes_len_);
+        if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) ::munmap(cq_ptr_, cq_len_);
+        if (sq_ptr_ != MAP_FAILED) ::munmap(sq_ptr_, sq_len_);
+        ::close(ring_fd_);
+    }
+
+    void submit_read(int fd, uint8_t* buf, size_t len, off_t offset,
+                     std::shared_ptr<IoCompletion> c) override {
+        queue(IORING_OP_READ, fd, buf, len, offset, std::move(c));
+    }
+
+    void submit_write(int fd, const uint8_t* buf, size_t len, off_t offset,
+                      std::shared_ptr<IoCompletion> c) override {
+        queue(IORING_OP_WRITE, fd, const_cast<uint8_t*>(buf), len, offset, std::move(c));
+    }
+
+    void submit() override {
+        std::lock_guard<std::mutex> lock(sq_mutex_);
+        submit_locked();
+    }
+
+    void wait(const IoCompletion& c) override {
+        if (c.done.load(std::memory_order_acquire)) {
+            return;
+        }
+        submit();
+
+        std::lock_guard<std::mutex> lock(cq_mutex_);
+        while (!c.done.load(std::memory_order_acquire)) {
+            if (reap_locked() == 0) {
+                enter(0, 1, IORING_ENTER_GETEVENTS);
+            }
+        }
+    }
+
+    void wait_all() override {
+        submit();
+
+        std::lock_guard<std::mutex> lock(cq_mutex_);
+        while (outstanding_ > 0) {
+            if (reap_locked() == 0) {
+                enter(0, 1, IORING_ENTER_GETEVENTS);
+            }
+        }
+    }
+
+    IoBackendKind kind() const override {
+        return IoBackendKind::IoUring;
+    }
+
+private:
+    /**
+     * One request in flight, kept to finish a short transfer.
+     */
+    struct Request {
+        std::shared_ptr<IoCompletion> c;
+        uint8_t opcode = 0;
+        int fd = -1;
+        uint8_t* buf = nullptr;
+        size_t len = 0;
+        off_t offset = 0;
+    };
+
+    explicit UringBackend(int fd) : ring_fd_(fd) {}
+
+    bool supports(uint8_t opcode) {
+        constexpr unsigned MAX_OPS = 256;
+        std::vector<uint8_t> buf(sizeof(io_uring_probe) + MAX_OPS * sizeof(io_uring_probe_op));
+        auto* probe = reinterpret_cast<io_uring_probe*>(buf.data());
+        if (sys_io_uring_register(ring_fd_, IORING_REGISTER_PROBE, probe, MAX_OPS) < 0) {
+            return false;
+        }
+        return opcode <= probe->last_op && opcode < probe->ops_len &&
+               (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+
+    bool map_rings(const io_uring_params& p) {
+        sq_entries_ = p.sq_entries;
+        cq_entries_ = p.cq_entries;
+
+        sq_len_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_len_ = cq_len_ = std::max(sq_len_, cq_len_);
+        }
+
+        sq_ptr_ = ::mmap(nullptr, sq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ptr_ == MAP_FAILED) return false;
+
+        if (single_mmap) {
+            cq_ptr_ = sq_ptr_;
+        } else {
+            cq_ptr_ = ::mmap(nullptr, cq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             ring_fd_, IORING_OFF_CQ_RING);
+            if (cq_ptr_ == MAP_FAILED) return false;
+        }
+
+        sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<uint8_t*>(sq_ptr_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+
+        auto* cq = static_cast<uint8_t*>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        return true;
+    }
+
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        for (;;) {
+            int ret = sys_io_uring_enter(ring_fd_, to_submit, min_complete, flags);
+            if (ret >= 0) return ret;
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EBUSY) return 0;
+            throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+        }
+    }
+
+    void queue(uint8_t opcode, int fd, uint8_t* buf, size_t len, off_t offset,
+               std::shared_ptr<IoCompletion> c) {
+        c->expected = len;
+
+        std::lock_guard<std::mutex> lock(sq_mutex_);
+
+        // Never have more requests outstanding than the completion ring holds
+        if (outstanding_ >= cq_entries_) {
+            submit_locked();
+            std::lock_guard<std::mutex> cq_lock(cq_mutex_);
+            while (outstanding_ >= cq_entries_) {
+                if (reap_locked() == 0) {
+                    enter(0, 1, IORING_ENTER_GETEVENTS);
+                }
+            }
+        }
+
+        // Submission ring full: hand the batch to the kernel first
+        unsigned tail = *sq_tail_;
+        while (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+            submit_locked();
+        }
+
+        unsigned idx = tail & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[idx];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buf);
+        sqe->len = static_cast<uint32_t>(len);
+        sqe->off = static_cast<uint64_t>(offset);
+        sqe->user_data = reinterpret_cast<uint64_t>(c.get());
+        sq_array_[idx] = idx;
+
+        {
+            std::lock_guard<std::mutex> in_lock(inflight_mutex_);
+            IoCompletion* key = c.get();
+            inflight_.emplace(key, Request{std::move(c), opcode, fd, buf, len, offset});
+        }
+        outstanding_++;
+        queued_++;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    // Caller holds sq_mutex_
+    void submit_locked() {
+        while (queued_ > 0) {
+            int n = enter(queued_, 0, 0);
+            if (n == 0) {
+                // Kernel is backed up: drain some completions and retry
+                std::lock_guard<std::mutex> cq_lock(cq_mutex_);
+                if (reap_locked() == 0) {
+                    enter(0, 1, IORING_ENTER_GETEVENTS);
+                }
+                continue;
+            }
+            queued_ -= static_cast<unsigned>(n);
+        }
+    }
+
+    // Caller holds cq_mutex_. Returns the number of completions reaped.
+    size_t reap_locked() {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        size_t reaped = 0;
+
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            auto* key = reinterpret_cast<IoCompletion*>(cqe.user_data);
+            ssize_t res = cqe.res;
+            head++;
+
+            Request req;
+            {
+                std::lock_guard<std::mutex> in_lock(inflight_mutex_);
+                auto it = inflight_.find(key);
+                req = std::move(it->second);
+                inflight_.erase(it);
+            }
+            if (res >= 0 && static_cast<size_t>(res) < req.len) {
+                res = finish_short(req, static_cast<size_t>(res));
+            }
+            complete(*req.c, res);
+            outstanding_--;
+            reaped++;
+        }
+
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return reaped;
+    }
+
+    // Transfers the rest of a short request synchronously. Returns the
+    // request's result: len, the bytes done before end of file, or -errno.
+    static ssize_t finish_short(const Request& req, size_t done) {
+        errno = 0;
+        bool ok = req.opcode == IORING_OP_READ
+                      ? pread_full(req.fd, req.buf + done, req.len - done,
+                                   req.offset + static_cast<off_t>(done))
+                      : pwrite_full(req.fd, req.buf + done, req.len - done,
+                                    req.offset + static_cast<off_t>(done));
+        if (ok) {
+            return static_cast<ssize_t>(req.len);
+        }
+        return errno != 0 ? -errno : static_cast<ssize_t>(done);
+    }
+
+    int ring_fd_;
+    void* sq_ptr_ = MAP_FAILED;
+    void* cq_ptr_ = MAP_FAILED;
+    io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sq_len_ = 0;
+    size_t cq_len_ = 0;
+    size_t sqes_len_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned cq_mask_ = 0;
+    unsigned cq_entries_ = 0;
+
+    unsigned queued_ = 0;                  // in the ring but not yet submitted
+    std::atomic<size_t> outstanding_{0};   // queued or submitted, not yet reaped
+
+    std::mutex sq_mutex_;
+    std::mutex cq_mutex_;
+    std::mutex inflight_mutex_;
+    std::unordered_map<const IoCompletion*, Request> inflight_;
+};
+
+} // namespace
+
+std::unique_ptr<IoBackend> make_io_backend(IoBackendKind kind, unsigned queue_depth) {
+    if (kind == IoBackendKind::IoUring) {
+        if (auto ring = UringBackend::create(queue_depth)) {
+            return ring;
+        }
+    }
+    return std::make_unique<PreadBackend>();
+}
+
+} // namespace file
@@ -2,40 +2,89 @@
 #include <cstring>
 #include <algorithm>
 #include <limits>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <mutex>
 
 namespace file {
 
-Page::Page(size_t blocksize) : bb_(blocksize, 0) {}
+void Page::FreeDeleter::operator()(uint8_t* p) const {
+    if (owned) {
+        std::free(p);
+    }
+}
 
-Page::Page(std::vector<uint8_t> data) : bb_(std::move(data)) {}
+size_t Page::alignment_for(size_t size) {
+    if (size % 4096 == 0) return 4096;
+    if (size % 512 == 0) return 512;
+    return alignof(std::max_align_t);
+}
 
-void Page::check_bounds(size_t offset, size_t size) const {
-    if (offset + size > bb_.size()) {
-        throw std::out_of_range("Page access out of bounds");
+uint8_t* Page::allocate(size_t size) {
+    void* p = nullptr;
+    // posix_memalign rejects a zero size on some platforms
+    if (::posix_memalign(&p, alignment_for(size), std::max<size_t>(size, 1)) != 0) {
+        throw std::bad_alloc();
     }
+    std::memset(p, 0, size);
+    return static_cast<uint8_t*>(p);
 }
 
-int32_t Page::get_int(size_t offset) const {
-    check_bounds(offset, 4);
+Page::Page(size_t blocksize, ByteOrder order)
+    : bb_(allocate(blocksize)), size_(blocksize), order_(order) {}
 
-    // Read 4 bytes in big-endian order
-    int32_t result = 0;
-    result |= static_cast<int32_t>(bb_[offset + 0]) << 24;
-    result |= static_cast<int32_t>(bb_[offset + 1]) << 16;
-    result |= static_cast<int32_t>(bb_[offset + 2]) << 8;
-    result |= static_cast<int32_t>(bb_[offset + 3]) << 0;
+Page::Page(std::vector<uint8_t> data, ByteOrder order)
+    : bb_(allocate(data.size())), size_(data.size()), order_(order) {
+    std::memcpy(bb_.get(), data.data(), size_);
+}
+
+Page::Page(uint8_t* storage, size_t blocksize, ByteOrder order)
+    : bb_(storage, FreeDeleter(false)), size_(blocksize), order_(order) {}
 
-    return result;
+Page::Page(const Page& other)
+    : bb_(allocate(other.size_)), size_(other.size_), order_(other.order_) {
+    std::memcpy(bb_.get(), other.data(), size_);
 }
 
-void Page::set_int(size_t offset, int32_t val) {
-    check_bounds(offset, 4);
+Page::Page(Page&& other) noexcept
+    : bb_(std::move(other.bb_)), size_(other.size_),
+      view_(other.view_.load(std::memory_order_relaxed)), order_(other.order_) {
+    other.size_ = 0;
+    other.view_.store(nullptr, std::memory_order_relaxed);
+}
 
-    // Write 4 bytes in big-endian order
-    bb_[offset + 0] = static_cast<uint8_t>((val >> 24) & 0xFF);
-    bb_[offset + 1] = static_cast<uint8_t>((val >> 16) & 0xFF);
-    bb_[offset + 2] = static_cast<uint8_t>((val >> 8) & 0xFF);
-    bb_[offset + 3] = static_cast<uint8_t>((val >> 0) & 0xFF);
+Page& Page::operator=(const Page& other) {
+    if (this != &other) {
+        Page copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+Page& Page::operator=(Page&& other) noexcept {
+    bb_ = std::move(other.bb_);
+    size_ = other.size_;
+    view_.store(other.view_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    order_ = other.order_;
+    other.size_ = 0;
+    other.view_.store(nullptr, std::memory_order_relaxed);
+    return *this;
+}
+
+void Page::materialize() {
+    if (view_.load(std::memory_order_acquire) == nullptr) {
+        return;
+    }
+    // Pages are materialized at most once per read, so one lock for all
+    // of them is enough
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    const uint8_t* view = view_.load(std::memory_order_relaxed);
+    if (view != nullptr) {
+        std::memcpy(bb_.get(), view, size_);
+        view_.store(nullptr, std::memory_order_release);
+    }
 }
 
 const uint8_t* Page::get_bytes(size_t offset) const {
@@ -47,7 +96,7 @@ const uint8_t* Page::get_bytes(size_t offset) const {
     }
 
     check_bounds(offset + 4, static_cast<size_t>(length));
-    return &bb_[offset + 4];
+    return data() + offset + 4;
 }
 
 size_t Page::get_bytes_length(size_t offset) const {
@@ -72,7 +121,7 @@ void Page::set_bytes(size_t offset, const uint8_t* data, size_t length) {
     set_int(offset, static_cast<int32_t>(length));
 
     // Write data
-    std::memcpy(&bb_[offset + 4], data, length);
+    std::memcpy(bb_.get() + offset + 4, data, length);
 }
 
 std::string Page::get_string(size_t offset) const {
@@ -82,6 +131,13 @@ std::string Page::get_string(size_t offset) const {
     return std::string(reinterpret_cast<const char*>(bytes), length);
 }
 
+std::string_view Page::get_string_view(size_t offset) const {
+    const uint8_t* bytes = get_bytes(offset);
+    size_t length = get_bytes_length(offset);
+
+    return std::string_view(reinterpret_cast<const char*>(bytes), length);
+}
+
 void Page::set_string(size_t offset, const std::string& val) {
     set_bytes(offset, reinterpret_cast<const uint8_t*>(val.data()), val.length());
 }
@@ -93,15 +149,36 @@ size_t Page::max_length(size_t strlen) {
 }
 
 size_t Page::size() const {
-    return bb_.size();
+    return size_;
+}
+
+uint8_t* Page::contents() {
+    materialize();
+    return bb_.get();
+}
+
+const uint8_t* Page::contents() const {
+    return data();
+}
+
+void Page::set_view(const uint8_t* region) {
+    view_.store(region, std::memory_order_release);
+}
+
+void Page::clear_view() {
+    view_.store(nullptr, std::memory_order_release);
+}
+
+bool Page::is_view() const {
+    return view_.load(std::memory_order_acquire) != nullptr;
 }
 
-std::vector<uint8_t>& Page::contents() {
-    return bb_;
+ByteOrder Page::byte_order() const {
+    return order_;
 }
 
-const std::vector<uint8_t>& Page::contents() const {
-    return bb_;
+void Page::set_byte_order(ByteOrder order) {
+    order_ = order;
 }
 
 } // namespace file
@@ -4,7 +4,9 @@
 namespace log {
 
 LogIterator::LogIterator(std::shared_ptr<file::FileMgr> fm, const file::BlockId& blk)
-    : fm_(fm), blk_(blk), page_(fm->block_size()), currentpos_(0), boundary_(0) {
+    : fm_(fm), blk_(blk), page_(fm->block_size(), fm->byte_order()), currentpos_(0), boundary_(0) {
+    // The log is read from the newest block back to the oldest
+    fm_->advise(blk.file_name(), file::AccessHint::Reverse);
     move_to_block(blk);
 }
 
@@ -32,7 +34,7 @@ std::vector<uint8_t> LogIterator::next() {
 
     // If current page is exhausted, move to previous block
     if (currentpos_ >= static_cast<int32_t>(fm_->block_size())) {
-        blk_ = file::BlockId(blk_.file_name(), blk_.number() - 1);
+        blk_ = file::BlockId(blk_.file_id(), blk_.number() - 1);
         move_to_block(blk_);
     }
 
@@ -1,93 +1,342 @@
 #include "log/logmgr.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <stdexcept>
 
 namespace log {
 
-// Static helper function
-file::BlockId LogMgr::append_new_block_helper(
-    file::FileMgr* fm,
-    file::Page& logpage,
-    const std::string& logfile
-) {
-    file::BlockId blk = fm->append(logfile);
-    // Set boundary to end of page (records will grow backward from here)
-    logpage.set_int(0, static_cast<int32_t>(fm->block_size()));
-    fm->write(blk, logpage);
-    return blk;
+LogMgr::LogBlock::LogBlock(size_t blocksize, file::ByteOrder order, size_t words)
+    : page(blocksize, order), copied(new std::atomic<uint64_t>[words]) {
+    for (size_t w = 0; w < words; w++) {
+        copied[w].store(0, std::memory_order_relaxed);
+    }
 }
 
-LogMgr::LogMgr(std::shared_ptr<file::FileMgr> fm, const std::string& logfile)
+LogMgr::LogMgr(std::shared_ptr<file::FileMgr> fm, const std::string& logfile,
+               const LogMgrOptions& options)
     : fm_(fm),
       logfile_(logfile),
-      logpage_(fm->block_size()),
-      currentblk_("", 0),
-      latest_lsn_(0),
-      last_saved_lsn_(0) {
+      blocksize_(fm->block_size()),
+      usable_(fm->block_size() - 4),
+      options_(options),
+      reserve_(0),
+      current_(0),
+      flushpage_(fm->block_size(), fm->byte_order()) {
+    if (blocksize_ >= ROLLING) {
+        throw std::invalid_argument("Log block size must be below 1 MB");
+    }
+    // Every record takes at least its 4-byte length
+    size_t words = usable_ / 4 / 64 + 1;
+    size_t blocks = std::max<size_t>(options_.buffer_bytes / blocksize_, 2);
+    for (size_t i = 0; i < blocks; i++) {
+        ring_.push_back(std::make_unique<LogBlock>(blocksize_, fm_->byte_order(), words));
+    }
+    drain_blocks_ = std::max<size_t>(blocks / DRAIN_FRACTION, 1);
 
     size_t logsize = fm_->length(logfile_);
-
+    int32_t blknum;
+    size_t used = 0;
     if (logsize == 0) {
-        // New log file - create first block
-        currentblk_ = append_new_block_helper(fm_.get(), logpage_, logfile_);
+        // New log file - create first block, with the boundary at the end
+        // of the page (records will grow backward from there)
+        blknum = fm_->append(logfile_).number();
+        slot(blknum).page.set_int(0, static_cast<int32_t>(blocksize_));
+        fm_->write(file::BlockId(logfile_, blknum), slot(blknum).page);
     } else {
         // Existing log file - load the last block
-        currentblk_ = file::BlockId(logfile_, static_cast<int32_t>(logsize) - 1);
-        fm_->read(currentblk_, logpage_);
+        blknum = static_cast<int32_t>(logsize) - 1;
+        fm_->read(file::BlockId(logfile_, blknum), slot(blknum).page);
+        used = blocksize_ - static_cast<size_t>(slot(blknum).page.get_int(0));
     }
-}
 
-size_t LogMgr::append(const std::vector<uint8_t>& logrec) {
-    // Get current boundary (first free position in page)
-    int32_t boundary = logpage_.get_int(0);
-
-    // Calculate space needed: 4 bytes for length + record data
-    int32_t recsize = static_cast<int32_t>(logrec.size());
-    int32_t bytesneeded = recsize + 4;
+    LogBlock& blk = slot(blknum);
+    blk.first_lsn = 1;
+    reserve_.store(used, std::memory_order_relaxed);
+    current_.store(blknum, std::memory_order_relaxed);
+    closed_through_ = blknum - 1;
+    next_to_write_ = blknum;
+    written_block_ = blknum;
+    flusher_ = std::thread([this] { flusher_loop(); });
+}
 
-    // Check if record fits in current page
-    // Need to leave at least 4 bytes for the boundary itself
-    if (boundary - bytesneeded < 4) {
-        // Page is full - flush and allocate new block
-        flush_impl();
-        currentblk_ = append_new_block();
-        boundary = logpage_.get_int(0);
+LogMgr::~LogMgr() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        requested_lsn_ = std::max(requested_lsn_,
+                                  static_cast<size_t>(reserve_.load() >> USED_BITS));
     }
+    work_.notify_one();
+    flusher_.join();
+}
 
-    // Calculate position for new record (grows backward)
-    int32_t recpos = boundary - bytesneeded;
+size_t LogMgr::append(const std::vector<uint8_t>& logrec) {
+    // Space needed: 4 bytes for length + record data, after the 4 bytes
+    // of the boundary itself
+    size_t recsize = logrec.size() + 4;
+    if (recsize > usable_) {
+        throw std::invalid_argument("Log record does not fit in a block");
+    }
 
-    // Write the record
-    logpage_.set_bytes(static_cast<size_t>(recpos), logrec.data(), logrec.size());
+    uint64_t observed = reserve_.load(std::memory_order_acquire);
+    while (true) {
+        uint64_t used = observed & USED_MASK;
+        if (used == ROLLING) {
+            observed = wait_for_rollover();
+            continue;
+        }
 
-    // Update boundary to point to start of this record
-    logpage_.set_int(0, recpos);
+        if (used + recsize <= usable_) {
+            // current_ only changes while the word reads ROLLING, so it is
+            // the block of observed if the exchange succeeds
+            int32_t blknum = current_.load(std::memory_order_acquire);
+            uint64_t reserved = observed + (uint64_t{1} << USED_BITS) + recsize;
+            if (reserve_.compare_exchange_weak(observed, reserved, std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+                size_t lsn = static_cast<size_t>(observed >> USED_BITS) + 1;
+                copy_record(blknum, used, lsn, logrec);
+                return lsn;
+            }
+            continue;
+        }
 
-    // Increment and return LSN
-    latest_lsn_++;
-    return latest_lsn_;
+        // Page is full - close it and continue in the next block
+        size_t lsn;
+        int32_t blknum;
+        if (roll_over(observed, recsize, lsn, blknum)) {
+            copy_record(blknum, 0, lsn, logrec);
+            return lsn;
+        }
+        observed = reserve_.load(std::memory_order_acquire);
+    }
 }
 
 void LogMgr::flush(size_t lsn) {
-    // Only flush if the requested LSN hasn't been saved yet
-    if (lsn >= last_saved_lsn_) {
-        flush_impl();
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+    // Only flush if the requested LSN hasn't been saved yet; each flush
+    // costs an fdatasync of the log. LSNs not handed out yet count as the
+    // latest one, which is all a write can cover.
+    lsn = std::min(lsn, static_cast<size_t>(reserve_.load(std::memory_order_acquire) >> USED_BITS));
+    if (lsn <= durable_lsn_) {
+        return;
+    }
+    stats_.flush_requests++;
+    requested_lsn_ = std::max(requested_lsn_, lsn);
+    waiting_++;
+    work_.notify_one();
+    flushed_.wait(lock, [&] { return durable_lsn_ >= lsn || error_; });
+    waiting_--;
+    if (durable_lsn_ < lsn) {
+        std::rethrow_exception(error_);
     }
 }
 
+size_t LogMgr::durable_lsn() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return durable_lsn_;
+}
+
+LogStats LogMgr::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
 std::unique_ptr<LogIterator> LogMgr::iterator() {
     // Flush to ensure all records are on disk
-    flush_impl();
-    // Create iterator starting at current block
-    return std::make_unique<LogIterator>(fm_, currentblk_);
+    flush(static_cast<size_t>(reserve_.load(std::memory_order_acquire) >> USED_BITS));
+    int32_t blknum;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        blknum = written_block_;
+    }
+    // Create iterator starting at the last block written
+    return std::make_unique<LogIterator>(fm_, file::BlockId(logfile_, blknum));
 }
 
-file::BlockId LogMgr::append_new_block() {
-    return append_new_block_helper(fm_.get(), logpage_, logfile_);
+void LogMgr::copy_record(int32_t blknum, size_t used, size_t lsn,
+                         const std::vector<uint8_t>& logrec) {
+    LogBlock& blk = slot(blknum);
+
+    // Records grow backward from the end of the page
+    size_t recpos = blocksize_ - used - (logrec.size() + 4);
+    blk.page.set_bytes(recpos, logrec.data(), logrec.size());
+
+    size_t idx = lsn - blk.first_lsn;
+    blk.copied[idx / 64].fetch_or(uint64_t{1} << (idx % 64), std::memory_order_release);
 }
 
-void LogMgr::flush_impl() {
-    fm_->write(currentblk_, logpage_);
-    last_saved_lsn_ = latest_lsn_;
+bool LogMgr::roll_over(uint64_t observed, size_t recsize, size_t& lsn, int32_t& blknum) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t rolling = (observed & ~USED_MASK) | ROLLING;
+    if (!reserve_.compare_exchange_strong(observed, rolling, std::memory_order_acq_rel,
+                                          std::memory_order_acquire)) {
+        return false;
+    }
+
+    int32_t closing = current_.load(std::memory_order_relaxed);
+    LogBlock& old = slot(closing);
+    old.last_lsn = static_cast<size_t>(observed >> USED_BITS);
+    old.final_used = static_cast<size_t>(observed & USED_MASK);
+    closed_through_ = closing;
+
+    // The next block reuses a ring block once the flusher has written the
+    // block held there before
+    blknum = closing + 1;
+    int32_t ring = static_cast<int32_t>(ring_.size());
+    if (drain_due()) {
+        work_.notify_one();
+    }
+    if (blknum >= next_to_write_ + ring) {
+        stats_.ring_waits++;
+        space_wanted_ = true;
+        work_.notify_one();
+        space_.wait(lock, [&] { return blknum < next_to_write_ + ring || error_; });
+        if (blknum >= next_to_write_ + ring) {
+            closed_through_ = closing - 1;
+            reserve_.store(observed, std::memory_order_release);
+            lock.unlock();
+            rolled_.notify_all();
+            std::rethrow_exception(error_);
+        }
+    }
+
+    // Free space is zeroed, as in a partial block, not left over from the
+    // block held there before
+    LogBlock& next = slot(blknum);
+    std::memset(next.page.contents() + sizeof(int32_t), 0, blocksize_ - sizeof(int32_t));
+    lsn = old.last_lsn + 1;
+    next.first_lsn = lsn;
+    for (size_t w = 0; w < usable_ / 4 / 64 + 1; w++) {
+        next.copied[w].store(0, std::memory_order_relaxed);
+    }
+    current_.store(blknum, std::memory_order_release);
+    reserve_.store((static_cast<uint64_t>(lsn) << USED_BITS) | recsize, std::memory_order_release);
+    lock.unlock();
+    rolled_.notify_all();
+    return true;
+}
+
+uint64_t LogMgr::wait_for_rollover() {
+    for (int spins = 0; spins < 64; spins++) {
+        uint64_t observed = reserve_.load(std::memory_order_acquire);
+        if ((observed & USED_MASK) != ROLLING) {
+            return observed;
+        }
+    }
+    // The rollover may be waiting for the flusher
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t observed;
+    rolled_.wait(lock, [&] {
+        observed = reserve_.load(std::memory_order_acquire);
+        return (observed & USED_MASK) != ROLLING;
+    });
+    return observed;
+}
+
+void LogMgr::wait_copied(const LogBlock& blk, size_t last_lsn) {
+    if (last_lsn < blk.first_lsn) {
+        return;
+    }
+    size_t count = last_lsn - blk.first_lsn + 1;
+    for (size_t w = 0; w * 64 < count; w++) {
+        size_t bits = std::min<size_t>(64, count - w * 64);
+        uint64_t mask = bits == 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+        for (int spins = 0; (blk.copied[w].load(std::memory_order_acquire) & mask) != mask;
+             spins++) {
+            if (spins >= 64) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+void LogMgr::flusher_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_.wait(lock, [this] {
+            return stopping_ || space_wanted_ || drain_due() || requested_lsn_ > durable_lsn_;
+        });
+        bool sync = requested_lsn_ > durable_lsn_;
+        bool draining = !sync && !space_wanted_;
+        if (draining && !drain_due()) {
+            return;  // stopping, and everything is on disk
+        }
+        if (sync && options_.group_wait_us > 0 && waiting_ < options_.group_max && !stopping_) {
+            work_.wait_for(lock, std::chrono::microseconds(options_.group_wait_us), [this] {
+                return waiting_ >= options_.group_max || space_wanted_ || stopping_;
+            });
+        }
+        space_wanted_ = false;
+
+        // Closed blocks go out whole; for a sync, the records of the
+        // current block reserved so far go out too
+        int32_t first = next_to_write_;
+        int32_t last_closed = closed_through_;
+        int32_t open = -1;
+        size_t open_lsn = 0;
+        size_t open_used = 0;
+        uint64_t observed = reserve_.load(std::memory_order_acquire);
+        if (sync && (observed & USED_MASK) != ROLLING) {
+            open = current_.load(std::memory_order_relaxed);
+            open_lsn = static_cast<size_t>(observed >> USED_BITS);
+            open_used = static_cast<size_t>(observed & USED_MASK);
+        }
+        size_t target = durable_lsn_;
+        if (open >= 0) {
+            target = open_lsn;
+        } else if (last_closed >= first) {
+            target = slot(last_closed).last_lsn;
+        }
+        lock.unlock();
+
+        try {
+            std::vector<file::Page*> closed;
+            for (int32_t b = first; b <= last_closed; b++) {
+                LogBlock& blk = slot(b);
+                wait_copied(blk, blk.last_lsn);
+                blk.page.set_int(0, static_cast<int32_t>(blocksize_ - blk.final_used));
+                closed.push_back(&blk.page);
+            }
+            fm_->write_range(logfile_, first, closed.size(), closed.data());
+            if (open >= 0) {
+                // Appends keep copying into the rest of the page meanwhile
+                LogBlock& blk = slot(open);
+                wait_copied(blk, open_lsn);
+                size_t start = blocksize_ - open_used;
+                // Free space is zeroed, not left over from the last block
+                std::memset(flushpage_.contents() + sizeof(int32_t), 0, start - sizeof(int32_t));
+                std::memcpy(flushpage_.contents() + start, blk.page.contents() + start, open_used);
+                flushpage_.set_int(0, static_cast<int32_t>(start));
+                fm_->write(file::BlockId(logfile_, open), flushpage_);
+            }
+            if (sync) {
+                fm_->sync(logfile_);
+            }
+        } catch (...) {
+            lock.lock();
+            error_ = std::current_exception();
+            flushed_.notify_all();
+            space_.notify_all();
+            return;
+        }
+
+        lock.lock();
+        next_to_write_ = last_closed + 1;
+        written_block_ = std::max(written_block_, open >= 0 ? open : last_closed);
+        if (draining) {
+            stats_.drained_blocks += static_cast<size_t>(last_closed - first + 1);
+        }
+        if (sync) {
+            durable_lsn_ = std::max(durable_lsn_, target);
+            stats_.group_flushes++;
+            flushed_.notify_all();
+        }
+        space_.notify_all();
+    }
 }
 
 } // namespace log
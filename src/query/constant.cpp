@@ -14,6 +14,10 @@ Constant Constant::with_string(const std::string& sval) {
     return Constant(sval);
 }
 
+Constant Constant::with_string(std::string&& sval) {
+    return Constant(std::move(sval));
+}
+
 // Getters
 std::optional<int> Constant::as_int() const {
     if (std::holds_alternative<int>(value_)) {
@@ -59,6 +63,25 @@ bool Constant::operator>=(const Constant& other) const {
     return !(*this < other);
 }
 
+bool Constant::operator==(std::string_view sval) const {
+    const std::string* s = std::get_if<std::string>(&value_);
+    return s != nullptr && *s == sval;
+}
+
+bool Constant::operator!=(std::string_view sval) const {
+    return !(*this == sval);
+}
+
+bool Constant::operator<(std::string_view sval) const {
+    const std::string* s = std::get_if<std::string>(&value_);
+    return s == nullptr || std::string_view(*s) < sval;
+}
+
+bool Constant::operator>(std::string_view sval) const {
+    const std::string* s = std::get_if<std::string>(&value_);
+    return s != nullptr && std::string_view(*s) > sval;
+}
+
 // Hash support
 size_t Constant::hash() const {
     return std::visit([](const auto& val) -> size_t {
@@ -66,6 +89,11 @@ size_t Constant::hash() const {
     }, value_);
 }
 
+size_t Constant::hash(std::string_view sval) {
+    // std::hash<string_view> matches std::hash<string> for the same characters
+    return std::hash<std::string_view>{}(sval);
+}
+
 // String representation
 std::string Constant::to_string() const {
     return std::visit([](const auto& val) -> std::string {
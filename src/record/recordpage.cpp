@@ -1,49 +1,84 @@
 #include "record/recordpage.hpp"
+#include <stdexcept>
 
 namespace record {
 
-RecordPage::RecordPage(buffer::Buffer& buff, const Layout& layout)
-    : buff_(buff), layout_(layout) {}
+RecordPage::RecordPage(buffer::Buffer& buff, const Layout& layout, PageAccess access)
+    : buff_(buff), layout_(layout), access_(access) {}
 
 int32_t RecordPage::get_int(size_t slot, const std::string& fldname) {
     size_t fldpos = offset(slot) + layout_.offset(fldname);
-    return buff_.contents().get_int(fldpos);
+    return buff_.read_optimistic([&] { return buff_.contents().get_int(fldpos); });
 }
 
 std::string RecordPage::get_string(size_t slot, const std::string& fldname) {
     size_t fldpos = offset(slot) + layout_.offset(fldname);
-    return buff_.contents().get_string(fldpos);
+    return buff_.read_optimistic([&] { return buff_.contents().get_string(fldpos); });
+}
+
+std::string_view RecordPage::get_string_view(size_t slot, const std::string& fldname) {
+    size_t fldpos = offset(slot) + layout_.offset(fldname);
+    if (access_ == PageAccess::Write) {
+        return buff_.contents().get_string_view(fldpos);
+    }
+
+    // As read_optimistic(), but the view outlives the check: the version
+    // is kept for release_views() to check again
+    while (true) {
+        uint64_t version = buff_.read_version();
+        try {
+            std::string_view view = buff_.contents().get_string_view(fldpos);
+            if (buff_.validate(version)) {
+                if (!view_version_.has_value()) {
+                    view_version_ = version;
+                }
+                return view;
+            }
+        } catch (...) {
+            if (buff_.validate(version)) {
+                throw;
+            }
+        }
+    }
 }
 
 void RecordPage::set_int(size_t slot, const std::string& fldname, int32_t val) {
+    check_writable();
     size_t fldpos = offset(slot) + layout_.offset(fldname);
+    buffer::FrameWriteLatch latch(buff_);
     buff_.contents().set_int(fldpos, val);
     buff_.set_modified(0, std::nullopt);  // Mark buffer as dirty (txnum=0 for Phase 4)
 }
 
 void RecordPage::set_string(size_t slot, const std::string& fldname, const std::string& val) {
+    check_writable();
     size_t fldpos = offset(slot) + layout_.offset(fldname);
+    buffer::FrameWriteLatch latch(buff_);
     buff_.contents().set_string(fldpos, val);
     buff_.set_modified(0, std::nullopt);  // Mark buffer as dirty (txnum=0 for Phase 4)
 }
 
 void RecordPage::delete_record(size_t slot) {
+    check_writable();
+    buffer::FrameWriteLatch latch(buff_);
     set_flag(slot, Flag::EMPTY);
     buff_.set_modified(0, std::nullopt);  // Mark buffer as dirty (txnum=0 for Phase 4)
 }
 
 void RecordPage::format() {
+    check_writable();
+    buffer::FrameWriteLatch latch(buff_);
     size_t slot = 0;
     while (is_valid_slot(slot)) {
-        // Set flag to EMPTY
-        buff_.contents().set_int(offset(slot), static_cast<int32_t>(Flag::EMPTY));
+        // Set flag to EMPTY; the slot was validated above, so skip the bounds checks
+        buff_.contents().set_int_unchecked(offset(slot), static_cast<int32_t>(Flag::EMPTY));
 
         // Initialize fields to zero/empty
         for (const auto& fldname : layout_.schema()->fields()) {
             size_t fldpos = offset(slot) + layout_.offset(fldname);
 
             if (layout_.schema()->type(fldname) == Type::INTEGER) {
-                buff_.contents().set_int(fldpos, 0);
+                buff_.contents().set_int_unchecked(fldpos, 0);
             } else {
                 buff_.contents().set_string(fldpos, "");
             }
@@ -54,10 +89,13 @@ void RecordPage::format() {
 }
 
 std::optional<size_t> RecordPage::next_after(std::optional<size_t> slot) {
-    return search_after(slot, Flag::USED);
+    return buff_.read_optimistic([&] { return search_after(slot, Flag::USED); });
 }
 
 std::optional<size_t> RecordPage::insert_after(std::optional<size_t> slot) {
+    check_writable();
+    // Latched across the search, so no other writer takes the same slot
+    buffer::FrameWriteLatch latch(buff_);
     std::optional<size_t> newslot = search_after(slot, Flag::EMPTY);
     if (newslot.has_value()) {
         set_flag(newslot.value(), Flag::USED);
@@ -70,15 +108,32 @@ const file::BlockId& RecordPage::block() const {
     return buff_.block().value();
 }
 
+PageAccess RecordPage::access() const {
+    return access_;
+}
+
 void RecordPage::set_flag(size_t slot, Flag flag) {
     buff_.contents().set_int(offset(slot), static_cast<int32_t>(flag));
 }
 
 RecordPage::Flag RecordPage::get_flag(size_t slot) {
-    int32_t flag_val = buff_.contents().get_int(offset(slot));
+    // Only called on slots search_after() has validated
+    int32_t flag_val = buff_.contents().get_int_unchecked(offset(slot));
     return static_cast<Flag>(flag_val);
 }
 
+bool RecordPage::release_views() {
+    bool valid = !view_version_.has_value() || buff_.validate(view_version_.value());
+    view_version_.reset();
+    return valid;
+}
+
+void RecordPage::check_writable() const {
+    if (access_ == PageAccess::Read) {
+        throw std::logic_error("RecordPage was opened for reading");
+    }
+}
+
 std::optional<size_t> RecordPage::search_after(std::optional<size_t> slot, Flag flag) {
     size_t current = slot.has_value() ? slot.value() + 1 : 0;
 
@@ -1,34 +1,61 @@
 #include "record/tablescan.hpp"
+#include <algorithm>
+#include <stdexcept>
 
 namespace record {
 
 TableScan::TableScan(std::shared_ptr<buffer::BufferMgr> bm,
                      const std::string& tablename,
-                     const Layout& layout)
-    : bm_(bm), layout_(layout), filename_(tablename + ".tbl"),
-      currentslot_(std::nullopt), current_buffer_idx_(std::nullopt) {
+                     const Layout& layout,
+                     PageAccess access)
+    : bm_(bm), layout_(layout), access_(access), filename_(tablename + ".tbl"),
+      file_id_(bm->file_mgr()->file_id(filename_)), currentslot_(std::nullopt), current_buffer_idx_(std::nullopt) {
+
+    // Table scans read blocks in increasing order
+    bm_->file_mgr()->advise(filename_, file::AccessHint::Sequential);
+
+    size_t length = bm_->file_mgr()->length(filename_);
+    if (length > bm_->num_buffers() / RING_SCAN_FRACTION) {
+        ring_ = std::make_unique<buffer::BufferRing>(
+            std::min(RING_BUFFERS, bm_->num_buffers() / 8));
+    }
 
     // If table file has blocks, move to first block
-    // Otherwise, create the first block
-    if (bm_->file_mgr()->length(filename_) == 0) {
-        move_to_new_block();
+    // Otherwise, create the first block (unless only reading)
+    if (length == 0) {
+        if (access_ == PageAccess::Write) {
+            move_to_new_block();
+        }
     } else {
         move_to_block(0);
     }
 }
 
 void TableScan::before_first() {
+    if (bm_->file_mgr()->length(filename_) == 0) {
+        return;  // a read-only scan of an empty table
+    }
+    requested_to_ = 0;
+    load_ahead(0);
     move_to_block(0);
 }
 
 bool TableScan::next() {
+    if (!rp_) {
+        return false;
+    }
+    if (!rp_->release_views()) {
+        throw StaleViewException();
+    }
     currentslot_ = rp_->next_after(currentslot_);
 
     while (!currentslot_.has_value()) {
         if (at_last_block()) {
             return false;
         }
-        move_to_block(rp_->block().number() + 1);
+        int32_t next_blk = rp_->block().number() + 1;
+        load_ahead(next_blk);
+        move_to_block(next_blk);
         currentslot_ = rp_->next_after(currentslot_);
     }
     return true;
@@ -42,6 +69,10 @@ std::string TableScan::get_string(const std::string& fldname) {
     return rp_->get_string(currentslot_.value(), fldname);
 }
 
+std::string_view TableScan::get_string_view(const std::string& fldname) {
+    return rp_->get_string_view(currentslot_.value(), fldname);
+}
+
 Constant TableScan::get_val(const std::string& fldname) {
     if (layout_.schema()->type(fldname) == Type::INTEGER) {
         return Constant::with_int(get_int(fldname));
@@ -78,6 +109,9 @@ void TableScan::set_string(const std::string& fldname, const std::string& val) {
 }
 
 void TableScan::insert() {
+    if (access_ == PageAccess::Read) {
+        throw std::logic_error("TableScan was opened for reading");
+    }
     currentslot_ = rp_->insert_after(currentslot_);
 
     while (!currentslot_.has_value()) {
@@ -103,18 +137,40 @@ std::optional<RID> TableScan::get_rid() const {
 
 void TableScan::move_to_rid(const RID& rid) {
     close();
-    file::BlockId blk(filename_, rid.block_number());
+    file::BlockId blk(file_id_, rid.block_number());
     current_buffer_idx_ = bm_->pin(blk);
-    rp_ = std::make_unique<RecordPage>(bm_->buffer(current_buffer_idx_.value()), layout_);
+    rp_ = std::make_unique<RecordPage>(bm_->buffer(current_buffer_idx_.value()), layout_,
+                                       access_);
     currentslot_ = rid.slot();
 }
 
+bool TableScan::uses_ring() const {
+    return ring_ != nullptr;
+}
+
+void TableScan::load_ahead(int32_t blknum) {
+    size_t limit = ring_ ? ring_->capacity() : bm_->available();
+    size_t run = std::min(READ_RUN_BLOCKS, limit / 4);
+    if (run <= 1) {
+        return;
+    }
+    if (blknum >= requested_to_) {
+        size_t loaded = bm_->load_range(filename_, blknum, run, ring_.get());
+        requested_to_ = blknum + static_cast<int32_t>(std::max<size_t>(loaded, 1));
+    }
+    if (requested_to_ - blknum < static_cast<int32_t>(run)) {
+        bm_->prefetch(filename_, requested_to_, run, ring_.get());
+        requested_to_ += static_cast<int32_t>(run);
+    }
+}
+
 void TableScan::move_to_block(int32_t blknum) {
     close();
 
-    file::BlockId blk(filename_, blknum);
-    current_buffer_idx_ = bm_->pin(blk);
-    rp_ = std::make_unique<RecordPage>(bm_->buffer(current_buffer_idx_.value()), layout_);
+    file::BlockId blk(file_id_, blknum);
+    current_buffer_idx_ = bm_->pin(blk, ring_.get());
+    rp_ = std::make_unique<RecordPage>(bm_->buffer(current_buffer_idx_.value()), layout_,
+                                       access_);
     currentslot_ = std::nullopt;
 }
 
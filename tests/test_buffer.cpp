@@ -193,6 +193,30 @@ TEST_F(BufferTest, FlushClearsModification) {
     EXPECT_FALSE(buf.modifying_tx().has_value());
 }
 
+TEST_F(BufferTest, FlushAsyncStaysDirtyUntilFinished) {
+    Buffer buf(fm, lm);
+    BlockId blk("testfile.dat", 0);
+    fm->append("testfile.dat");
+    buf.assign_to_block(blk);
+
+    buf.contents().set_int(0, 789);
+    buf.set_modified(1, std::nullopt);
+    Page copy(blocksize);
+    IoHandle handle = buf.flush_async(copy);
+    fm->wait(handle);
+    EXPECT_TRUE(buf.modifying_tx().has_value());
+
+    buf.finish_flush();
+    EXPECT_FALSE(buf.modifying_tx().has_value());
+
+    Page read_page(blocksize);
+    fm->read(blk, read_page);
+    EXPECT_EQ(read_page.get_int(0), 789);
+
+    // Nothing to write for a clean buffer
+    EXPECT_TRUE(buf.flush_async(copy).done());
+}
+
 TEST_F(BufferTest, ReassignFlushesOldBlock) {
     Buffer buf(fm, lm);
 
@@ -245,4 +269,68 @@ TEST_F(BufferTest, FlushRespectsWAL) {
     EXPECT_EQ(read_page.get_int(0), 789);
 }
 
+// ============================================================================
+// Frame Latch Tests
+// ============================================================================
+
+TEST_F(BufferTest, WriteLatchPublishesANewVersion) {
+    Buffer buf(fm, lm);
+
+    uint64_t v = buf.read_version();
+    EXPECT_EQ(v % 2, 0u);
+    EXPECT_TRUE(buf.validate(v));
+
+    {
+        FrameWriteLatch latch(buf);
+        EXPECT_FALSE(buf.validate(v));
+    }
+    EXPECT_FALSE(buf.validate(v));
+
+    uint64_t after = buf.read_version();
+    EXPECT_EQ(after % 2, 0u);
+    EXPECT_GT(after, v);
+    EXPECT_TRUE(buf.validate(after));
+}
+
+TEST_F(BufferTest, OptimisticReadRetriesAfterAWrite) {
+    Buffer buf(fm, lm);
+    buf.contents().set_int(0, 1);
+
+    // The first attempt races with a writer and must not be returned
+    int calls = 0;
+    int32_t value = buf.read_optimistic([&] {
+        int32_t seen = buf.contents().get_int(0);
+        if (calls++ == 0) {
+            FrameWriteLatch latch(buf);
+            buf.contents().set_int(0, 2);
+        }
+        return seen;
+    });
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(value, 2);
+}
+
+TEST_F(BufferTest, OptimisticReadPassesOnConsistentExceptions) {
+    Buffer buf(fm, lm);
+
+    int calls = 0;
+    EXPECT_THROW(buf.read_optimistic([&]() -> int32_t {
+        calls++;
+        return buf.contents().get_int(blocksize);
+    }), std::out_of_range);
+    EXPECT_EQ(calls, 1);
+
+    // An exception from an inconsistent read is dropped and the read retried
+    calls = 0;
+    int32_t value = buf.read_optimistic([&]() -> int32_t {
+        if (calls++ == 0) {
+            FrameWriteLatch latch(buf);
+            throw std::out_of_range("torn read");
+        }
+        return 7;
+    });
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(value, 7);
+}
+
 // main() is provided by gtest_main
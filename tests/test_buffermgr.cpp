@@ -2,8 +2,11 @@
 #include "buffer/buffermgr.hpp"
 #include "file/filemgr.hpp"
 #include "log/logmgr.hpp"
+#include <cstddef>
 #include <filesystem>
+#include <fstream>
 #include <memory>
+#include <set>
 
 using namespace buffer;
 using namespace file;
@@ -178,6 +181,35 @@ TEST_F(BufferMgrTest, Eviction) {
     bm.unpin(idx3);
 }
 
+TEST_F(BufferMgrTest, PageTableFollowsEvictionAndReassignment) {
+    BufferMgr bm(fm, lm, 4);
+    const int32_t nblocks = 12;
+    for (int32_t i = 0; i < nblocks; i++) {
+        Page page(blocksize);
+        page.set_int(0, 1000 + i);
+        fm->write(fm->append("paged.dat"), page);
+    }
+
+    // Cycle through three times as many blocks as buffers, in a scrambled order
+    for (int round = 0; round < 5; round++) {
+        for (int32_t k = 0; k < nblocks; k++) {
+            int32_t b = (k * 5 + round) % nblocks;
+            BlockId blk("paged.dat", b);
+            size_t idx = bm.pin(blk);
+            ASSERT_TRUE(bm.buffer(idx).block().has_value());
+            EXPECT_EQ(bm.buffer(idx).block().value(), blk);
+            EXPECT_EQ(bm.buffer(idx).contents().get_int(0), 1000 + b);
+
+            // A second pin of a resident block finds the same buffer
+            size_t again = bm.pin(blk);
+            EXPECT_EQ(again, idx);
+            bm.unpin(again);
+            bm.unpin(idx);
+        }
+    }
+    EXPECT_EQ(bm.available(), 4u);
+}
+
 TEST_F(BufferMgrTest, FlushAll) {
     BufferMgr bm(fm, lm, 3);
 
@@ -208,6 +240,144 @@ TEST_F(BufferMgrTest, FlushAll) {
     bm.unpin(idx2);
 }
 
+TEST_F(BufferMgrTest, FlushAllSyncsEachFileOnce) {
+    BufferMgr bm(fm, lm, 4);
+    for (int i = 0; i < 3; i++) fm->append("synced.tbl");
+    fm->sync_all();
+    size_t before = fm->sync_count();
+
+    std::vector<size_t> idxs;
+    for (int32_t i = 0; i < 3; i++) {
+        size_t idx = bm.pin(BlockId("synced.tbl", i));
+        bm.buffer(idx).contents().set_int(0, i);
+        bm.buffer(idx).set_modified(7, std::nullopt);
+        idxs.push_back(idx);
+    }
+
+    bm.flush_all(7);
+    EXPECT_EQ(fm->sync_count(), before + 1);
+
+    for (size_t idx : idxs) bm.unpin(idx);
+}
+
+TEST_F(BufferMgrTest, FlushAllSyncsFilesWrittenByEviction) {
+    BufferMgr bm(fm, lm, 1);
+    fm->append("evicted.tbl");
+    fm->append("other.tbl");
+    fm->sync_all();
+    size_t before = fm->sync_count();
+
+    size_t idx = bm.pin(BlockId("evicted.tbl", 0));
+    bm.buffer(idx).contents().set_int(0, 31);
+    bm.buffer(idx).set_modified(9, std::nullopt);
+    bm.unpin(idx);
+
+    // Evicting the dirty page writes it without a sync
+    bm.unpin(bm.pin(BlockId("other.tbl", 0)));
+    EXPECT_EQ(fm->sync_count(), before);
+
+    bm.flush_all(9);
+    EXPECT_EQ(fm->sync_count(), before + 1);
+
+    // Only once
+    bm.flush_all(9);
+    EXPECT_EQ(fm->sync_count(), before + 1);
+}
+
+TEST_F(BufferMgrTest, FlushAllWritesOnlyTheTransactionsPages) {
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Naive;
+    options.partitions = 2;
+    BufferMgr bm(fm, lm, 8, options);
+    for (int i = 0; i < 3; i++) fm->append("commit.tbl");
+
+    std::vector<size_t> idxs;
+    for (int32_t i = 0; i < 3; i++) {
+        size_t idx = bm.pin(BlockId("commit.tbl", i));
+        bm.buffer(idx).contents().set_int(0, 100 + i);
+        bm.buffer(idx).set_modified(i < 2 ? 3 : 4, std::nullopt);
+        idxs.push_back(idx);
+    }
+
+    bm.flush_all(3);
+    EXPECT_EQ(bm.stats().commit_writes, 2u);
+    EXPECT_FALSE(bm.buffer(idxs[0]).modifying_tx().has_value());
+    EXPECT_FALSE(bm.buffer(idxs[1]).modifying_tx().has_value());
+    EXPECT_TRUE(bm.buffer(idxs[2]).modifying_tx().has_value());
+
+    Page page(blocksize);
+    for (int32_t i = 0; i < 2; i++) {
+        fm->read(BlockId("commit.tbl", i), page);
+        EXPECT_EQ(page.get_int(0), 100 + i);
+    }
+
+    // The list is consumed
+    bm.flush_all(3);
+    EXPECT_EQ(bm.stats().commit_writes, 2u);
+
+    for (size_t idx : idxs) bm.unpin(idx);
+}
+
+TEST_F(BufferMgrTest, FlushAllSkipsPagesTakenOverByAnotherTransaction) {
+    BufferMgr bm(fm, lm, 2);
+    fm->append("shared.tbl");
+
+    size_t idx = bm.pin(BlockId("shared.tbl", 0));
+    bm.buffer(idx).set_modified(1, std::nullopt);
+    bm.buffer(idx).set_modified(2, std::nullopt);
+
+    bm.flush_all(1);
+    EXPECT_EQ(bm.stats().commit_writes, 0u);
+    EXPECT_TRUE(bm.buffer(idx).modifying_tx().has_value());
+
+    bm.flush_all(2);
+    EXPECT_EQ(bm.stats().commit_writes, 1u);
+    EXPECT_FALSE(bm.buffer(idx).modifying_tx().has_value());
+
+    bm.unpin(idx);
+}
+
+TEST_F(BufferMgrTest, FlushAllWritesARedirtiedPageOnce) {
+    BufferMgr bm(fm, lm, 1);
+    fm->append("redirty.tbl");
+    fm->append("other.tbl");
+
+    size_t idx = bm.pin(BlockId("redirty.tbl", 0));
+    bm.buffer(idx).set_modified(5, std::nullopt);
+    bm.unpin(idx);
+    bm.unpin(bm.pin(BlockId("other.tbl", 0)));  // writes the page back
+
+    // Dirtied again by the same transaction: listed twice, written once
+    idx = bm.pin(BlockId("redirty.tbl", 0));
+    bm.buffer(idx).contents().set_int(0, 55);
+    bm.buffer(idx).set_modified(5, std::nullopt);
+    bm.flush_all(5);
+    EXPECT_EQ(bm.stats().commit_writes, 1u);
+
+    Page page(blocksize);
+    fm->read(BlockId("redirty.tbl", 0), page);
+    EXPECT_EQ(page.get_int(0), 55);
+
+    bm.unpin(idx);
+}
+
+TEST_F(BufferMgrTest, EvictionsCountCleanAndDirtyPages) {
+    BufferMgr bm(fm, lm, 1);
+    for (int i = 0; i < 3; i++) fm->append("evict.tbl");
+
+    size_t idx = bm.pin(BlockId("evict.tbl", 0));
+    bm.buffer(idx).set_modified(1, std::nullopt);
+    bm.unpin(idx);
+    bm.unpin(bm.pin(BlockId("evict.tbl", 1)));  // replaces a dirty page
+    bm.unpin(bm.pin(BlockId("evict.tbl", 2)));  // replaces a clean page
+
+    BufferStats stats = bm.stats();
+    EXPECT_EQ(stats.dirty_evictions, 1u);
+    EXPECT_EQ(stats.clean_evictions, 1u);
+    EXPECT_EQ(stats.background_writes, 0u);
+    EXPECT_EQ(bm.writer_rate(), 0.0);
+}
+
 TEST_F(BufferMgrTest, PinAfterUnpin) {
     BufferMgr bm(fm, lm, 2);
 
@@ -378,4 +548,419 @@ TEST_F(BufferMgrTest, ExhaustPoolThenRecover) {
     bm.unpin(idx3);
 }
 
+TEST_F(BufferMgrTest, RingRecyclesItsBuffers) {
+    // Clock hands out unused buffers first, so the ring fills up to its
+    // capacity (Naive would keep offering the same buffer)
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    BufferMgr bm(fm, lm, 8, options);
+    for (int i = 0; i < 10; i++) fm->append("ring.tbl");
+
+    BufferRing ring(2);
+    std::set<size_t> frames;
+    for (int32_t i = 0; i < 10; i++) {
+        size_t idx = bm.pin(BlockId("ring.tbl", i), &ring);
+        frames.insert(idx);
+        bm.unpin(idx);
+    }
+    EXPECT_EQ(frames.size(), 2u);
+    EXPECT_EQ(bm.stats().ring_reuses, 8u);
+}
+
+TEST_F(BufferMgrTest, RingDropsBuffersPinnedByOthers) {
+    BufferMgr bm(fm, lm, 8);
+    for (int i = 0; i < 4; i++) fm->append("ring.tbl");
+
+    BufferRing ring(1);
+    size_t first = bm.pin(BlockId("ring.tbl", 0), &ring);
+    bm.unpin(first);
+
+    // Someone else is using the page: the ring must leave it alone
+    size_t shared = bm.pin(BlockId("ring.tbl", 0));
+    size_t next = bm.pin(BlockId("ring.tbl", 1), &ring);
+    EXPECT_NE(next, shared);
+    EXPECT_EQ(bm.buffer(shared).block().value(), BlockId("ring.tbl", 0));
+    EXPECT_EQ(bm.stats().ring_reuses, 0u);
+    bm.unpin(next);
+    bm.unpin(shared);
+
+    // The ring now owns the new buffer and recycles that one
+    size_t third = bm.pin(BlockId("ring.tbl", 2), &ring);
+    EXPECT_EQ(third, next);
+    EXPECT_EQ(bm.stats().ring_reuses, 1u);
+    bm.unpin(third);
+}
+
+TEST_F(BufferMgrTest, LoadRangeIntoRing) {
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    BufferMgr bm(fm, lm, 16, options);
+    for (int32_t i = 0; i < 12; i++) {
+        Page page(blocksize);
+        page.set_int(0, 70 + i);
+        fm->write(fm->append("ringrun.tbl"), page);
+    }
+
+    BufferRing ring(4);
+    std::set<size_t> frames;
+    for (int32_t first = 0; first < 12; first += 2) {
+        EXPECT_EQ(bm.load_range("ringrun.tbl", first, 2, &ring), 2u);
+        for (int32_t b = first; b < first + 2; b++) {
+            size_t idx = bm.pin(BlockId("ringrun.tbl", b), &ring);
+            EXPECT_EQ(bm.buffer(idx).contents().get_int(0), 70 + b);
+            frames.insert(idx);
+            bm.unpin(idx);
+        }
+    }
+    EXPECT_EQ(frames.size(), 4u);
+}
+
+TEST_F(BufferMgrTest, FailedLoadRangeLeavesBlocksOut) {
+    BufferMgr bm(fm, lm, 4);
+
+    // Fill every frame with another block first
+    for (int32_t i = 0; i < 4; i++) {
+        Page page(blocksize);
+        page.set_int(0, 100 + i);
+        fm->write(fm->append("other.tbl"), page);
+        bm.unpin(bm.pin(BlockId("other.tbl", i)));
+    }
+    for (int32_t i = 0; i < 4; i++) {
+        fm->append("run.tbl");
+    }
+
+    // Shrink the file behind the FileMgr's back, so the vectored read fails
+    fs::resize_file(test_dir + "/run.tbl", 0);
+    EXPECT_THROW(bm.load_range("run.tbl", 0, 4), std::runtime_error);
+    EXPECT_EQ(bm.available(), 4);
+
+    // The blocks were not left resident with the frames' old contents
+    for (int32_t i = 0; i < 4; i++) {
+        Page page(blocksize);
+        page.set_int(0, 600 + i);
+        fm->write(BlockId("run.tbl", i), page);
+    }
+    for (int32_t i = 0; i < 4; i++) {
+        size_t idx = bm.pin(BlockId("run.tbl", i));
+        EXPECT_EQ(bm.buffer(idx).contents().get_int(0), 600 + i);
+        bm.unpin(idx);
+    }
+}
+
+TEST_F(BufferMgrTest, LoadRangeInstallsRun) {
+    BufferMgr bm(fm, lm, 8);
+
+    for (int32_t i = 0; i < 10; i++) {
+        Page page(blocksize);
+        page.set_int(0, 500 + i);
+        fm->write(fm->append("run.tbl"), page);
+    }
+
+    // Block 3 is already resident, so only 0..2 are loaded
+    size_t idx3 = bm.pin(BlockId("run.tbl", 3));
+    EXPECT_EQ(bm.load_range("run.tbl", 0, 6), 3);
+
+    // Loaded buffers stay unpinned
+    EXPECT_EQ(bm.available(), 7);
+
+    for (int32_t i = 0; i < 3; i++) {
+        size_t idx = bm.pin(BlockId("run.tbl", i));
+        EXPECT_EQ(bm.buffer(idx).contents().get_int(0), 500 + i);
+        bm.unpin(idx);
+    }
+
+    // Nothing to load past the end of the file or when already resident
+    EXPECT_EQ(bm.load_range("run.tbl", 10, 4), 0);
+    EXPECT_EQ(bm.load_range("run.tbl", 3, 4), 0);
+
+    // Runs are capped by the number of available buffers
+    EXPECT_EQ(bm.load_range("run.tbl", 4, 100), 6);
+
+    bm.unpin(idx3);
+}
+
+TEST_F(BufferMgrTest, PrefetchMakesBlocksResident) {
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    BufferMgr bm(fm, lm, 16, options);
+    for (int32_t i = 0; i < 8; i++) {
+        Page page(blocksize);
+        page.set_int(0, 90 + i);
+        fm->write(fm->append("hint.tbl"), page);
+    }
+
+    EXPECT_EQ(bm.prefetch("hint.tbl", 0, 4), 4u);
+    EXPECT_EQ(bm.available(), 16);
+
+    for (int32_t i = 0; i < 4; i++) {
+        size_t idx = bm.pin(BlockId("hint.tbl", i));
+        EXPECT_EQ(bm.buffer(idx).contents().get_int(0), 90 + i);
+        bm.unpin(idx);
+    }
+    BufferStats stats = bm.stats();
+    EXPECT_EQ(stats.prefetches, 4u);
+    EXPECT_EQ(stats.prefetch_hits, 4u);
+    EXPECT_EQ(stats.misses, 0u);
+
+    // Resident blocks and blocks past the end of the file are skipped
+    EXPECT_EQ(bm.prefetch("hint.tbl", 2, 4), 2u);
+    EXPECT_EQ(bm.prefetch("hint.tbl", 8, 4), 0u);
+}
+
+TEST_F(BufferMgrTest, ReadaheadFollowsSequentialPins) {
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    options.readahead_max = 16;
+    BufferMgr bm(fm, lm, 64, options);
+    for (int32_t i = 0; i < 40; i++) {
+        Page page(blocksize);
+        page.set_int(0, i);
+        fm->write(fm->append("seq.tbl"), page);
+    }
+
+    for (int32_t i = 0; i < 40; i++) {
+        size_t idx = bm.pin(BlockId("seq.tbl", i));
+        EXPECT_EQ(bm.buffer(idx).contents().get_int(0), i);
+        bm.unpin(idx);
+    }
+
+    // Only the two pins that established the sequence read on demand
+    BufferStats stats = bm.stats();
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.prefetch_hits, 38u);
+}
+
+TEST_F(BufferMgrTest, RandomPinsShrinkReadahead) {
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    options.readahead_max = 16;
+    BufferMgr bm(fm, lm, 64, options);
+    for (int32_t i = 0; i < 40; i++) {
+        fm->append("rand.tbl");
+    }
+
+    // The second sequential pin starts a window of four blocks
+    for (int32_t b : {0, 1}) {
+        bm.unpin(bm.pin(BlockId("rand.tbl", b)));
+    }
+    EXPECT_EQ(bm.stats().prefetches, 4u);
+
+    for (int32_t b : {20, 7, 30, 13}) {
+        bm.unpin(bm.pin(BlockId("rand.tbl", b)));
+    }
+    EXPECT_EQ(bm.stats().prefetches, 4u);
+
+    // Back in sequence, the window starts over from the minimum
+    bm.unpin(bm.pin(BlockId("rand.tbl", 14)));
+    EXPECT_EQ(bm.stats().prefetches, 8u);
+}
+
+TEST_F(BufferMgrTest, ReadaheadIsOffByDefault) {
+    BufferMgr bm(fm, lm, 16);
+    for (int32_t i = 0; i < 10; i++) {
+        bm.unpin(bm.pin(BlockId("plain.tbl", i)));
+    }
+    EXPECT_EQ(bm.stats().prefetches, 0u);
+}
+
+TEST_F(BufferMgrTest, FramesAreContiguousInTheArena) {
+    BufferMgr bm(fm, lm, 4);
+    EXPECT_EQ(bm.frame_memory(), FrameMemory::Arena);
+    const uint8_t* base = bm.buffer(0).contents().contents();
+    for (size_t i = 1; i < 4; i++) {
+        const uint8_t* frame = bm.buffer(i).contents().contents();
+        EXPECT_EQ(frame, base + i * blocksize);
+    }
+}
+
+TEST_F(BufferMgrTest, ArenaFramesAreBlockAligned) {
+    FrameArena arena(3, 4096, FrameMemory::Arena);
+    EXPECT_EQ(arena.stride(), 4096u);
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(arena.frame(i)) % 4096, 0u);
+        EXPECT_EQ(arena.frame(i)[4095], 0);
+    }
+
+    // Sizes that are not a multiple of 512 keep max_align_t alignment
+    FrameArena odd(3, 100, FrameMemory::Arena);
+    EXPECT_EQ(odd.stride() % alignof(std::max_align_t), 0u);
+    EXPECT_GE(odd.stride(), 100u);
+}
+
+TEST_F(BufferMgrTest, EveryFrameMemoryRoundTrips) {
+    for (int i = 0; i < 4; i++) fm->append("frames.tbl");
+    for (FrameMemory memory : {FrameMemory::Heap, FrameMemory::Arena, FrameMemory::HugePages,
+                               FrameMemory::HugeTlb}) {
+        BufferMgrOptions options;
+        options.frame_memory = memory;
+        BufferMgr bm(fm, lm, 2, options);
+        if (memory == FrameMemory::HugeTlb) {
+            // Depends on reserved huge pages; otherwise falls back
+            EXPECT_TRUE(bm.frame_memory() == FrameMemory::HugeTlb ||
+                        bm.frame_memory() == FrameMemory::HugePages);
+        } else {
+            EXPECT_EQ(bm.frame_memory(), memory);
+        }
+
+        for (int32_t b = 0; b < 4; b++) {
+            size_t idx = bm.pin(BlockId("frames.tbl", b));
+            bm.buffer(idx).contents().set_int(0, b * 10 + static_cast<int32_t>(memory));
+            bm.buffer(idx).set_modified(1, std::nullopt);
+            bm.unpin(idx);
+        }
+        bm.flush_all(1);
+
+        Page page(blocksize);
+        for (int32_t b = 0; b < 4; b++) {
+            fm->read(BlockId("frames.tbl", b), page);
+            EXPECT_EQ(page.get_int(0), b * 10 + static_cast<int32_t>(memory));
+        }
+    }
+}
+
+TEST_F(BufferMgrTest, ArenaFramesServeDirectIo) {
+    std::string direct_dir = test_dir + "/direct";
+    FileMgrOptions options;
+    options.direct_io = true;
+    auto dfm = std::make_shared<FileMgr>(direct_dir, 4096, options);
+    auto dlm = std::make_shared<LogMgr>(dfm, "direct.log");
+    for (int i = 0; i < 3; i++) dfm->append("direct.tbl");
+
+    {
+        BufferMgr bm(dfm, dlm, 2);
+        for (int32_t b = 0; b < 3; b++) {
+            size_t idx = bm.pin(BlockId("direct.tbl", b));
+            bm.buffer(idx).contents().set_int(0, 300 + b);
+            bm.buffer(idx).set_modified(1, std::nullopt);
+            bm.unpin(idx);
+        }
+        bm.flush_all(1);
+    }
+
+    BufferMgr bm(dfm, dlm, 2);
+    for (int32_t b = 0; b < 3; b++) {
+        size_t idx = bm.pin(BlockId("direct.tbl", b));
+        EXPECT_EQ(bm.buffer(idx).contents().get_int(0), 300 + b);
+        bm.unpin(idx);
+    }
+}
+
+TEST_F(BufferMgrTest, WarmRestartReloadsResidentSet) {
+    for (int i = 0; i < 8; i++) fm->append("warm.tbl");
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;  // Naive would reuse one frame
+    options.warm_file = test_dir + "/pool.warm";
+    {
+        BufferMgr bm(fm, lm, 8, options);
+        bm.wait_for_restore();
+        EXPECT_EQ(bm.stats().restored, 0u);  // nothing saved yet
+        for (int32_t b = 0; b < 5; b++) {
+            bm.unpin(bm.pin(BlockId("warm.tbl", b)));
+        }
+    }
+    ASSERT_TRUE(fs::exists(options.warm_file));
+
+    BufferMgr bm(fm, lm, 8, options);
+    bm.wait_for_restore();
+    EXPECT_EQ(bm.stats().restored, 5u);
+    for (int32_t b = 0; b < 5; b++) {
+        bm.unpin(bm.pin(BlockId("warm.tbl", b)));
+    }
+    EXPECT_EQ(bm.stats().hits, 5u);
+    EXPECT_EQ(bm.stats().misses, 0u);
+}
+
+TEST_F(BufferMgrTest, RestoreOnlyFillsFreeFrames) {
+    for (int i = 0; i < 6; i++) fm->append("fill.tbl");
+    std::string path = test_dir + "/fill.warm";
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    {
+        BufferMgr bm(fm, lm, 6, options);
+        for (int32_t b = 0; b < 6; b++) {
+            bm.unpin(bm.pin(BlockId("fill.tbl", b)));
+        }
+        EXPECT_EQ(bm.save_resident(path), 6u);
+    }
+
+    // A smaller pool already holding a live page: only the free frames
+    // are filled, and the live page stays
+    BufferMgr bm(fm, lm, 3, options);
+    fm->append("live.tbl");
+    bm.unpin(bm.pin(BlockId("live.tbl", 0)));
+    EXPECT_EQ(bm.restore_resident(path), 2u);
+    EXPECT_EQ(bm.stats().clean_evictions, 0u);
+    bm.unpin(bm.pin(BlockId("live.tbl", 0)));
+    EXPECT_EQ(bm.stats().hits, 1u);
+
+    // Already resident: nothing more to load
+    EXPECT_EQ(bm.restore_resident(path), 0u);
+}
+
+TEST_F(BufferMgrTest, RestoreSkipsMissingFilesAndBlocks) {
+    for (int i = 0; i < 4; i++) fm->append("kept.tbl");
+    fm->append("dropped.tbl");
+    std::string path = test_dir + "/skip.warm";
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    {
+        BufferMgr bm(fm, lm, 8, options);
+        for (int32_t b = 0; b < 4; b++) {
+            bm.unpin(bm.pin(BlockId("kept.tbl", b)));
+        }
+        bm.unpin(bm.pin(BlockId("kept.tbl", 6)));  // past the end of the file
+        bm.unpin(bm.pin(BlockId("dropped.tbl", 0)));
+        EXPECT_EQ(bm.save_resident(path), 6u);
+    }
+    fs::remove(test_dir + "/dropped.tbl");
+
+    BufferMgr bm(fm, lm, 8, options);
+    EXPECT_EQ(bm.restore_resident(path), 4u);
+    EXPECT_FALSE(fm->exists("dropped.tbl"));
+}
+
+TEST_F(BufferMgrTest, RestoreKeepsWarmBlocksWarm) {
+    for (int i = 0; i < 3; i++) fm->append("lru.tbl");
+    std::string path = test_dir + "/lru.warm";
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::LruK;
+    {
+        BufferMgr bm(fm, lm, 2, options);
+        bm.unpin(bm.pin(BlockId("lru.tbl", 0)));
+        bm.unpin(bm.pin(BlockId("lru.tbl", 1)));
+        bm.unpin(bm.pin(BlockId("lru.tbl", 0)));  // block 0 is warm
+        bm.save_resident(path);
+    }
+
+    BufferMgr bm(fm, lm, 2, options);
+    EXPECT_EQ(bm.restore_resident(path), 2u);
+    bm.unpin(bm.pin(BlockId("lru.tbl", 2)));  // evicts the cold block 1
+    bm.unpin(bm.pin(BlockId("lru.tbl", 0)));
+    EXPECT_EQ(bm.stats().hits, 1u);
+}
+
+TEST_F(BufferMgrTest, RestoreIgnoresMalformedFiles) {
+    BufferMgr bm(fm, lm, 4);
+    EXPECT_EQ(bm.restore_resident(test_dir + "/missing.warm"), 0u);
+
+    std::string path = test_dir + "/bad.warm";
+    std::ofstream(path) << "not a resident set";
+    EXPECT_EQ(bm.restore_resident(path), 0u);
+}
+
+TEST_F(BufferMgrTest, ResidentSetIsSavedOnATimer) {
+    fm->append("timer.tbl");
+    BufferMgrOptions options;
+    options.warm_file = test_dir + "/timer.warm";
+    options.warm_save_interval_ms = 5;
+    BufferMgr bm(fm, lm, 4, options);
+    bm.unpin(bm.pin(BlockId("timer.tbl", 0)));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!fs::exists(options.warm_file) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(fs::exists(options.warm_file));
+}
+
 // main() is provided by gtest_main
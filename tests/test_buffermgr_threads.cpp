@@ -0,0 +1,578 @@
+#include <gtest/gtest.h>
+#include "buffer/buffermgr.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace buffer;
+using namespace file;
+using namespace log;
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class BufferMgrThreadsTest : public ::testing::Test {
+protected:
+    std::string test_dir = "/tmp/mudopdb_buffermgr_threads_test";
+    std::string filename = "shared.dat";
+    size_t blocksize = 400;
+    static constexpr int32_t NUM_BLOCKS = 256;
+
+    std::shared_ptr<FileMgr> fm;
+    std::shared_ptr<LogMgr> lm;
+
+    void SetUp() override {
+        if (fs::exists(test_dir)) {
+            fs::remove_all(test_dir);
+        }
+        fs::create_directories(test_dir);
+        fm = std::make_shared<FileMgr>(test_dir, blocksize);
+        lm = std::make_shared<LogMgr>(fm, "test.log");
+
+        for (int32_t i = 0; i < NUM_BLOCKS; i++) {
+            Page page(blocksize);
+            page.set_int(0, i * 7);
+            fm->write(fm->append(filename), page);
+        }
+    }
+
+    void TearDown() override {
+        if (fs::exists(test_dir)) {
+            fs::remove_all(test_dir);
+        }
+    }
+
+    // Small per-thread generator so every thread gets its own sequence
+    static uint32_t next_random(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+// ============================================================================
+// Partitioning
+// ============================================================================
+
+TEST_F(BufferMgrThreadsTest, PartitionCountIsClamped) {
+    EXPECT_EQ(BufferMgr(fm, lm, 8).num_partitions(), 1u);
+    BufferMgrOptions options;
+    options.partitions = 8;
+    EXPECT_EQ(BufferMgr(fm, lm, 3, options).num_partitions(), 3u);
+    options.partitions = 0;
+    EXPECT_EQ(BufferMgr(fm, lm, 8, options).num_partitions(), 1u);
+
+    options.policy = ReplacementKind::Clock;
+    options.partitions = 4;
+    BufferMgr bm(fm, lm, 10, options);
+    EXPECT_EQ(bm.num_partitions(), 4u);
+    EXPECT_EQ(bm.available(), 10u);
+}
+
+TEST_F(BufferMgrThreadsTest, PartitionedPoolPinsEveryBlock) {
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    options.partitions = 4;
+    BufferMgr bm(fm, lm, 16, options);
+    for (int32_t i = 0; i < NUM_BLOCKS; i++) {
+        size_t idx = bm.pin(BlockId(filename, i));
+        EXPECT_EQ(bm.buffer(idx).block().value(), BlockId(filename, i));
+        EXPECT_EQ(bm.buffer(idx).contents().get_int(0), i * 7);
+        bm.unpin(idx);
+    }
+    EXPECT_EQ(bm.available(), 16u);
+}
+
+// ============================================================================
+// Stress Tests
+// ============================================================================
+
+TEST_F(BufferMgrThreadsTest, ConcurrentPinsSeeCorrectContents) {
+    const size_t numbuffs = 64;
+    const int num_threads = 8;
+    const int pins_per_thread = 3000;
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    options.partitions = 8;
+    BufferMgr bm(fm, lm, numbuffs, options);
+
+    std::atomic<int> errors{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            uint32_t rng = 0x9e3779b9u * static_cast<uint32_t>(t + 1);
+            for (int i = 0; i < pins_per_thread; i++) {
+                // Skewed: half the pins go to the first 16 blocks
+                uint32_t r = next_random(rng);
+                int32_t blknum = static_cast<int32_t>((r & 1) ? (r >> 1) % 16 : (r >> 1) % NUM_BLOCKS);
+                BlockId blk(filename, blknum);
+
+                size_t idx = bm.pin(blk);
+                Buffer& buff = bm.buffer(idx);
+                if (!buff.is_pinned() || buff.block().value() != blk ||
+                    buff.contents().get_int(0) != blknum * 7) {
+                    errors++;
+                }
+                bm.unpin(idx);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(bm.available(), numbuffs);
+    BufferStats stats = bm.stats();
+    EXPECT_EQ(stats.hits + stats.misses, static_cast<size_t>(num_threads * pins_per_thread));
+}
+
+TEST_F(BufferMgrThreadsTest, SharedBlockMapsToOneBuffer) {
+    const int num_threads = 8;
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::TwoQ;
+    options.partitions = 4;
+    BufferMgr bm(fm, lm, 16, options);
+    BlockId hot(filename, 5);
+
+    // While every thread holds a pin on the same block, they all see one buffer
+    std::vector<size_t> seen(num_threads);
+    std::atomic<int> pinned{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            seen[t] = bm.pin(hot);
+            pinned++;
+            while (pinned.load() < num_threads) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    for (int t = 1; t < num_threads; t++) {
+        EXPECT_EQ(seen[t], seen[0]);
+    }
+    for (int t = 0; t < num_threads; t++) {
+        bm.unpin(seen[t]);
+    }
+    EXPECT_FALSE(bm.buffer(seen[0]).is_pinned());
+    EXPECT_EQ(bm.available(), 16u);
+}
+
+TEST_F(BufferMgrThreadsTest, DirtyPagesSurviveConcurrentEviction) {
+    const size_t numbuffs = 16;
+    const int num_threads = 4;
+    const int rounds = 20;
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::LruK;
+    options.partitions = 4;
+    BufferMgr bm(fm, lm, numbuffs, options);
+
+    // Each thread owns the blocks congruent to its id, so page contents
+    // are never shared between threads
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            size_t txnum = static_cast<size_t>(t + 1);
+            for (int round = 1; round <= rounds; round++) {
+                for (int32_t b = t; b < NUM_BLOCKS; b += num_threads) {
+                    size_t idx = bm.pin(BlockId(filename, b));
+                    Buffer& buff = bm.buffer(idx);
+                    buff.contents().set_int(4, round * 1000 + b);
+                    buff.set_modified(txnum, std::nullopt);
+                    bm.unpin(idx);
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    for (int t = 0; t < num_threads; t++) {
+        bm.flush_all(static_cast<size_t>(t + 1));
+    }
+
+    for (int32_t b = 0; b < NUM_BLOCKS; b++) {
+        Page page(blocksize);
+        fm->read(BlockId(filename, b), page);
+        EXPECT_EQ(page.get_int(0), b * 7);
+        EXPECT_EQ(page.get_int(4), rounds * 1000 + b);
+    }
+}
+
+TEST_F(BufferMgrThreadsTest, ConcurrentLoadRangeAndPins) {
+    const int num_threads = 4;
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    options.partitions = 4;
+    BufferMgr bm(fm, lm, 64, options);
+
+    std::atomic<int> errors{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (int32_t first = t * 8; first < NUM_BLOCKS; first += num_threads * 8) {
+                bm.load_range(filename, first, 8);
+                for (int32_t b = first; b < first + 8; b++) {
+                    size_t idx = bm.pin(BlockId(filename, b));
+                    if (bm.buffer(idx).contents().get_int(0) != b * 7) {
+                        errors++;
+                    }
+                    bm.unpin(idx);
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(bm.available(), 64u);
+}
+
+// ============================================================================
+// Waiting For A Buffer
+// ============================================================================
+
+TEST_F(BufferMgrThreadsTest, WaiterWakesPromptlyOnUnpin) {
+    BufferMgr bm(fm, lm, 1);
+    size_t held = bm.pin(BlockId(filename, 0));
+
+    std::chrono::steady_clock::time_point released;
+    std::thread unpinner([&] {
+        while (bm.stats().waits < 1) {
+            std::this_thread::yield();
+        }
+        released = std::chrono::steady_clock::now();
+        bm.unpin(held);
+    });
+
+    size_t idx = bm.pin(BlockId(filename, 1));
+    auto woke = std::chrono::steady_clock::now();
+    unpinner.join();
+
+    EXPECT_EQ(bm.buffer(idx).contents().get_int(0), 7);
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(woke - released).count(), 50);
+    bm.unpin(idx);
+}
+
+TEST_F(BufferMgrThreadsTest, WaitersAreServedInFifoOrder) {
+    const int num_waiters = 4;
+    BufferMgr bm(fm, lm, 1);
+    size_t held = bm.pin(BlockId(filename, 0));
+
+    std::mutex order_mutex;
+    std::vector<int> order;
+    std::vector<std::thread> waiters;
+    for (int w = 0; w < num_waiters; w++) {
+        waiters.emplace_back([&, w] {
+            size_t idx = bm.pin(BlockId(filename, w + 1));
+            {
+                std::lock_guard<std::mutex> lock(order_mutex);
+                order.push_back(w);
+            }
+            bm.unpin(idx);
+        });
+        // Queue the waiters one at a time so their arrival order is known
+        while (bm.stats().waits < static_cast<size_t>(w + 1)) {
+            std::this_thread::yield();
+        }
+    }
+
+    bm.unpin(held);
+    for (auto& th : waiters) th.join();
+
+    ASSERT_EQ(order.size(), static_cast<size_t>(num_waiters));
+    for (int w = 0; w < num_waiters; w++) {
+        EXPECT_EQ(order[w], w);
+    }
+}
+
+TEST_F(BufferMgrThreadsTest, NewcomerQueuesBehindWaiters) {
+    BufferMgr bm(fm, lm, 1);
+    bm.set_max_time(2000);
+    size_t held = bm.pin(BlockId(filename, 0));
+
+    std::atomic<bool> waiter_served{false};
+    std::thread waiter([&] {
+        size_t idx = bm.pin(BlockId(filename, 1));
+        waiter_served = true;
+        // Hold the buffer until the newcomer has queued (or give up)
+        auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (bm.stats().waits < 2 && std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::yield();
+        }
+        bm.unpin(idx);
+    });
+    while (bm.stats().waits < 1) {
+        std::this_thread::yield();
+    }
+
+    // A resident block is still served immediately
+    size_t again = bm.pin(BlockId(filename, 0));
+    EXPECT_EQ(again, held);
+    bm.unpin(again);
+
+    // A miss queues even though the unpin below frees the buffer first
+    bm.unpin(held);
+    size_t idx = bm.pin(BlockId(filename, 2));
+    EXPECT_TRUE(waiter_served.load());
+    waiter.join();
+    EXPECT_EQ(bm.buffer(idx).contents().get_int(0), 14);
+    EXPECT_EQ(bm.stats().waits, 2u);
+    bm.unpin(idx);
+}
+
+TEST_F(BufferMgrThreadsTest, TimedOutWaiterLeavesQueue) {
+    BufferMgr bm(fm, lm, 1);
+    bm.set_max_time(20);
+    size_t held = bm.pin(BlockId(filename, 0));
+
+    EXPECT_THROW(bm.pin(BlockId(filename, 1)), BufferAbortException);
+    EXPECT_EQ(bm.stats().waits, 1u);
+
+    // The abandoned waiter must not hold up anyone once the buffer is free
+    bm.unpin(held);
+    size_t idx = bm.pin(BlockId(filename, 1));
+    EXPECT_EQ(bm.buffer(idx).contents().get_int(0), 7);
+    EXPECT_EQ(bm.stats().waits, 1u);
+    bm.unpin(idx);
+}
+
+// ============================================================================
+// Background Writer
+// ============================================================================
+
+namespace {
+
+// Polls until pred holds or about two seconds pass
+template <typename Pred>
+bool eventually(Pred pred) {
+    auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > give_up) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+BufferMgrOptions writer_options(size_t batch) {
+    BufferMgrOptions options;
+    options.background_writer = true;
+    options.writer_batch = batch;
+    options.writer_interval_ms = 2;
+    return options;
+}
+
+} // namespace
+
+TEST_F(BufferMgrThreadsTest, BackgroundWriterCleansUnpinnedPages) {
+    BufferMgr bm(fm, lm, 8, writer_options(2));
+
+    std::vector<uint8_t> rec = {1, 2, 3, 4};
+    std::vector<size_t> idxs;
+    for (int32_t b = 0; b < 4; b++) {
+        size_t idx = bm.pin(BlockId(filename, b));
+        bm.buffer(idx).contents().set_int(4, 900 + b);
+        bm.buffer(idx).set_modified(3, lm->append(rec));
+        idxs.push_back(idx);
+    }
+    for (size_t idx : idxs) bm.unpin(idx);
+
+    ASSERT_TRUE(eventually([&] { return bm.stats().background_writes >= 4; }));
+    for (int32_t b = 0; b < 4; b++) {
+        EXPECT_FALSE(bm.buffer(idxs[b]).modifying_tx().has_value());
+        Page page(blocksize);
+        fm->read(BlockId(filename, b), page);
+        EXPECT_EQ(page.get_int(4), 900 + b);
+    }
+    EXPECT_GT(bm.writer_rate(), 0.0);
+
+    // WAL: the log records were written before the pages
+    Page logpage(blocksize);
+    fm->read(BlockId("test.log", 0), logpage);
+    EXPECT_LT(logpage.get_int(0), static_cast<int32_t>(blocksize));
+}
+
+TEST_F(BufferMgrThreadsTest, BackgroundWriterSkipsPinnedPages) {
+    BufferMgr bm(fm, lm, 4, writer_options(64));
+    size_t idx = bm.pin(BlockId(filename, 0));
+    bm.buffer(idx).set_modified(4, std::nullopt);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(bm.stats().background_writes, 0u);
+    EXPECT_TRUE(bm.buffer(idx).modifying_tx().has_value());
+
+    bm.unpin(idx);
+    EXPECT_TRUE(eventually([&] { return bm.stats().background_writes == 1; }));
+}
+
+TEST_F(BufferMgrThreadsTest, BackgroundWriterLeavesCleanVictims) {
+    BufferMgr bm(fm, lm, 4, writer_options(64));
+    std::vector<size_t> idxs;
+    for (int32_t b = 0; b < 4; b++) {
+        size_t idx = bm.pin(BlockId(filename, b));
+        bm.buffer(idx).set_modified(5, std::nullopt);
+        idxs.push_back(idx);
+    }
+    for (size_t idx : idxs) bm.unpin(idx);
+    ASSERT_TRUE(eventually([&] { return bm.stats().background_writes == 4; }));
+
+    for (int32_t b = 4; b < 8; b++) {
+        bm.unpin(bm.pin(BlockId(filename, b)));
+    }
+    BufferStats stats = bm.stats();
+    EXPECT_EQ(stats.clean_evictions, 4u);
+    EXPECT_EQ(stats.dirty_evictions, 0u);
+
+    // The pages were written but not synced; flush_all(5) still syncs them
+    size_t before = fm->sync_count();
+    bm.flush_all(5);
+    EXPECT_EQ(fm->sync_count(), before + 1);
+}
+
+// ============================================================================
+// Readahead
+// ============================================================================
+
+TEST_F(BufferMgrThreadsTest, ConcurrentScansWithReadahead) {
+    // io_uring, where available, keeps prefetch reads in flight while
+    // other threads pin and evict
+    FileMgrOptions fm_options;
+    fm_options.io_backend = IoBackendKind::IoUring;
+    auto async_fm = std::make_shared<FileMgr>(test_dir, blocksize, fm_options);
+
+    const int num_threads = 4;
+    const int32_t span = NUM_BLOCKS / num_threads;
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    options.partitions = 4;
+    options.readahead_max = 16;
+    BufferMgr bm(async_fm, lm, 32, options);
+
+    std::atomic<int> errors{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (int pass = 0; pass < 3; pass++) {
+                for (int32_t b = t * span; b < (t + 1) * span; b++) {
+                    size_t idx = bm.pin(BlockId(filename, b));
+                    if (bm.buffer(idx).contents().get_int(0) != b * 7) {
+                        errors++;
+                    }
+                    bm.unpin(idx);
+                }
+            }
+        });
+    }
+    threads.emplace_back([&] {
+        uint32_t state = 99;
+        for (int i = 0; i < 300; i++) {
+            int32_t b = static_cast<int32_t>(next_random(state) % NUM_BLOCKS);
+            size_t idx = bm.pin(BlockId(filename, b));
+            if (bm.buffer(idx).contents().get_int(0) != b * 7) {
+                errors++;
+            }
+            bm.unpin(idx);
+        }
+    });
+    for (auto& th : threads) th.join();
+
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_GT(bm.stats().prefetch_hits, 0u);
+    EXPECT_EQ(bm.available(), 32u);
+}
+
+// ============================================================================
+// Warm Restart
+// ============================================================================
+
+TEST_F(BufferMgrThreadsTest, PinsRunWhileResidentSetReloads) {
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    options.partitions = 4;
+    options.warm_file = test_dir + "/pool.warm";
+    {
+        BufferMgr bm(fm, lm, 128, options);
+        for (int32_t b = 0; b < 128; b++) {
+            bm.unpin(bm.pin(BlockId(filename, b)));
+        }
+    }
+
+    BufferMgr bm(fm, lm, 128, options);
+    std::atomic<int> errors{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            uint32_t rng = 99 + static_cast<uint32_t>(t);
+            for (int i = 0; i < 500; i++) {
+                int32_t b = static_cast<int32_t>(next_random(rng) % NUM_BLOCKS);
+                size_t idx = bm.pin(BlockId(filename, b));
+                if (bm.buffer(idx).contents().get_int(0) != b * 7) {
+                    errors++;
+                }
+                bm.unpin(idx);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    bm.wait_for_restore();
+
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(bm.available(), 128u);
+}
+
+// ============================================================================
+// Frame latch
+// ============================================================================
+
+TEST_F(BufferMgrThreadsTest, OptimisticReadersNeverSeeTornWrites) {
+    BufferMgr bm(fm, lm, 8);
+    size_t idx = bm.pin(BlockId(filename, 0));
+    Buffer& buff = bm.buffer(idx);
+    {
+        FrameWriteLatch latch(buff);
+        buff.contents().set_int(0, 0);
+        buff.contents().set_int(200, 0);
+    }
+
+    // The writer keeps two far-apart integers equal under the latch
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int32_t i = 1; i <= 20000; i++) {
+            FrameWriteLatch latch(buff);
+            buff.contents().set_int(0, i);
+            buff.contents().set_int(200, i);
+        }
+        done = true;
+    });
+
+    std::atomic<int> torn{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&] {
+            while (!done) {
+                auto pair = buff.read_optimistic([&] {
+                    return std::make_pair(buff.contents().get_int(0),
+                                          buff.contents().get_int(200));
+                });
+                if (pair.first != pair.second) {
+                    torn++;
+                }
+            }
+        });
+    }
+    writer.join();
+    for (auto& th : readers) th.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(buff.read_optimistic([&] { return buff.contents().get_int(0); }), 20000);
+    bm.unpin(idx);
+}
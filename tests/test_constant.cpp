@@ -151,6 +151,29 @@ TEST(Constant, HashInUnorderedSet) {
   EXPECT_TRUE(set.find(c3) != set.end());
 }
 
+TEST(Constant, CompareWithStringView) {
+  auto s = Constant::with_string("bob");
+  auto i = Constant::with_int(7);
+  std::string_view bob = "bob";
+
+  EXPECT_TRUE(s == bob);
+  EXPECT_FALSE(s != bob);
+  EXPECT_TRUE(s < std::string_view("carol"));
+  EXPECT_TRUE(s > std::string_view("alice"));
+  EXPECT_FALSE(s < bob);
+  EXPECT_FALSE(s > bob);
+
+  // Ints never equal strings and order before them
+  EXPECT_FALSE(i == bob);
+  EXPECT_TRUE(i < bob);
+  EXPECT_FALSE(i > bob);
+}
+
+TEST(Constant, StringViewHashMatchesConstantHash) {
+  std::string_view view = "hash me";
+  EXPECT_EQ(Constant::hash(view), Constant::with_string("hash me").hash());
+}
+
 // ============================================================================
 // Test copy and move semantics
 // ============================================================================
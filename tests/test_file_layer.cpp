@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
 #include "file/blockid.hpp"
+#include "file/fileregistry.hpp"
 #include "file/page.hpp"
 #include "file/filemgr.hpp"
 #include <filesystem>
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <type_traits>
 #include <unordered_set>
 
 using namespace file;
@@ -79,6 +84,59 @@ TEST(BlockIdTest, UnorderedSet) {
     EXPECT_TRUE(block_set.find(blk2) != block_set.end());
 }
 
+TEST(BlockIdTest, InternedFileIds) {
+    BlockId blk1("interned_a.tbl", 3);
+    BlockId blk2("interned_a.tbl", 9);
+    BlockId blk3("interned_b.tbl", 3);
+
+    EXPECT_EQ(blk1.file_id(), blk2.file_id());
+    EXPECT_NE(blk1.file_id(), blk3.file_id());
+    EXPECT_EQ(FileRegistry::name_of(blk3.file_id()), "interned_b.tbl");
+
+    // Building from the id gives the same block as building from the name
+    BlockId from_id(FileRegistry::id_of("interned_a.tbl"), 3);
+    EXPECT_EQ(from_id, blk1);
+    EXPECT_EQ(from_id.file_name(), "interned_a.tbl");
+    EXPECT_NE(from_id.to_string().find("interned_a.tbl"), std::string::npos);
+
+    EXPECT_EQ(sizeof(BlockId), 8u);
+    EXPECT_TRUE(std::is_trivially_copyable<BlockId>::value);
+}
+
+TEST(BlockIdTest, OrderingFollowsNamesNotIds) {
+    // Registered in reverse alphabetical order
+    BlockId later("ordering_z.dat", 0);
+    BlockId earlier("ordering_a.dat", 0);
+    EXPECT_TRUE(earlier < later);
+    EXPECT_FALSE(later < earlier);
+}
+
+TEST(FileRegistryTest, UnknownIdThrows) {
+    EXPECT_THROW(FileRegistry::name_of(static_cast<FileId>(FileRegistry::size())),
+                 std::out_of_range);
+}
+
+TEST(FileRegistryTest, ConcurrentRegistrationAssignsOneIdPerName) {
+    const int nthreads = 4;
+    const int nnames = 200;
+    std::vector<std::vector<FileId>> ids(nthreads, std::vector<FileId>(nnames));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; t++) {
+        threads.emplace_back([&ids, t] {
+            for (int i = 0; i < nnames; i++) {
+                ids[t][i] = FileRegistry::id_of("concurrent_" + std::to_string(i));
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    for (int t = 1; t < nthreads; t++) {
+        EXPECT_EQ(ids[t], ids[0]);
+    }
+    std::unordered_set<FileId> distinct(ids[0].begin(), ids[0].end());
+    EXPECT_EQ(distinct.size(), static_cast<size_t>(nnames));
+}
+
 // ============================================================================
 // Page Tests
 // ============================================================================
@@ -120,7 +178,7 @@ TEST(PageTest, IntegerOperations) {
 }
 
 TEST(PageTest, IntegerBigEndian) {
-    Page page(400);
+    Page page(400, ByteOrder::BigEndian);
 
     // Set integer
     page.set_int(0, 0x12345678);
@@ -132,6 +190,56 @@ TEST(PageTest, IntegerBigEndian) {
     EXPECT_EQ(page.contents()[3], 0x78);
 }
 
+TEST(PageTest, StringViewReadsInPlace) {
+    Page page(400);
+    page.set_string(40, "zero copy");
+
+    std::string_view view = page.get_string_view(40);
+    EXPECT_EQ(view, "zero copy");
+    EXPECT_EQ(reinterpret_cast<const uint8_t*>(view.data()),
+              static_cast<const Page&>(page).contents() + 44);
+
+    page.set_string(100, "");
+    EXPECT_TRUE(page.get_string_view(100).empty());
+    EXPECT_THROW(page.get_string_view(398), std::out_of_range);
+}
+
+TEST(PageTest, IntegerLittleEndian) {
+    Page page(400);
+    EXPECT_EQ(page.byte_order(), ByteOrder::LittleEndian);
+
+    page.set_int(0, 0x12345678);
+    EXPECT_EQ(page.contents()[0], 0x78);
+    EXPECT_EQ(page.contents()[1], 0x56);
+    EXPECT_EQ(page.contents()[2], 0x34);
+    EXPECT_EQ(page.contents()[3], 0x12);
+}
+
+TEST(PageTest, ByteOrderOnlyChangesInterpretation) {
+    Page page(400, ByteOrder::BigEndian);
+    page.set_int(8, -2);
+    page.set_string(20, "endian");
+
+    page.set_byte_order(ByteOrder::LittleEndian);
+    EXPECT_EQ(page.get_int(8), static_cast<int32_t>(0xFEFFFFFF));
+
+    page.set_byte_order(ByteOrder::BigEndian);
+    EXPECT_EQ(page.get_int(8), -2);
+    EXPECT_EQ(page.get_string(20), "endian");
+}
+
+TEST(PageTest, UncheckedAccessorsMatchChecked) {
+    for (ByteOrder order : {ByteOrder::BigEndian, ByteOrder::LittleEndian}) {
+        Page page(64, order);
+        page.set_int_unchecked(4, -123456);
+        EXPECT_EQ(page.get_int(4), -123456);
+        page.set_int(60, 987654);
+        EXPECT_EQ(page.get_int_unchecked(60), 987654);
+    }
+    Page page(64);
+    EXPECT_THROW(page.get_int(61), std::out_of_range);
+}
+
 TEST(PageTest, StringOperations) {
     Page page(400);
 
@@ -222,6 +330,116 @@ TEST(PageTest, MultipleWrites) {
     EXPECT_EQ(page.get_string(0), "Second");
 }
 
+TEST(PageTest, ViewAndCopyOnWrite) {
+    Page source(400);
+    source.set_int(0, 11);
+    source.set_string(8, "viewed");
+
+    Page page(400);
+    page.set_view(static_cast<const Page&>(source).contents());
+
+    // Reads come from the viewed region
+    EXPECT_TRUE(page.is_view());
+    EXPECT_EQ(page.get_int(0), 11);
+    EXPECT_EQ(page.get_string(8), "viewed");
+
+    // The first write copies the region and detaches from it
+    page.set_int(0, 22);
+    EXPECT_FALSE(page.is_view());
+    EXPECT_EQ(page.get_int(0), 22);
+    EXPECT_EQ(page.get_string(8), "viewed");
+    EXPECT_EQ(source.get_int(0), 11);
+}
+
+TEST(PageTest, CopyOfViewOwnsViewedBytes) {
+    Page source(400);
+    source.set_int(0, 11);
+
+    Page page(400);
+    page.set_view(static_cast<const Page&>(source).contents());
+
+    // Copies take the viewed bytes, not the stale own storage
+    Page copy(page);
+    EXPECT_FALSE(copy.is_view());
+    EXPECT_EQ(copy.get_int(0), 11);
+
+    Page assigned(400);
+    assigned = page;
+    EXPECT_FALSE(assigned.is_view());
+    EXPECT_EQ(assigned.get_int(0), 11);
+
+    source.set_int(0, 12);
+    EXPECT_EQ(copy.get_int(0), 11);
+    EXPECT_EQ(assigned.get_int(0), 11);
+}
+
+TEST(PageTest, RacingWritersMaterializeOnce) {
+    Page source(4096);
+    for (size_t off = 0; off < 4096; off += 4) {
+        source.set_int(off, -1);
+    }
+
+    for (int round = 0; round < 50; round++) {
+        Page page(4096);
+        page.set_view(static_cast<const Page&>(source).contents());
+
+        // Writers to disjoint halves, as log appenders do; neither write
+        // may be lost to the other's copy of the viewed region
+        std::thread first([&] { page.set_int(0, round); });
+        std::thread second([&] { page.set_int(2048, round); });
+        first.join();
+        second.join();
+
+        EXPECT_FALSE(page.is_view());
+        EXPECT_EQ(page.get_int(0), round);
+        EXPECT_EQ(page.get_int(2048), round);
+        EXPECT_EQ(page.get_int(4), -1);
+    }
+}
+
+TEST(PageTest, ClearViewRestoresOwnStorage) {
+    Page source(400);
+    source.set_int(0, 11);
+
+    Page page(400);
+    page.set_int(0, 5);
+    page.set_view(static_cast<const Page&>(source).contents());
+    EXPECT_EQ(page.get_int(0), 11);
+
+    page.clear_view();
+    EXPECT_FALSE(page.is_view());
+    EXPECT_EQ(page.get_int(0), 5);
+}
+
+TEST(PageTest, StorageIsBlockAligned) {
+    Page page(4096);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(page.contents()) % 4096, 0u);
+
+    Page copy(page);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(copy.contents()) % 4096, 0u);
+
+    Page sector(512);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(sector.contents()) % 512, 0u);
+}
+
+TEST(PageTest, BorrowedStorage) {
+    std::vector<uint8_t> storage(400, 0);
+    {
+        Page page(storage.data(), storage.size());
+        page.set_int(8, 77);
+        EXPECT_EQ(page.contents(), storage.data());
+
+        // A copy gets storage of its own
+        Page copy(page);
+        EXPECT_NE(copy.contents(), storage.data());
+        copy.set_int(8, 1);
+        EXPECT_EQ(page.get_int(8), 77);
+    }
+    // Still readable after the page is gone: it was never freed
+    Page reader(storage, ByteOrder::LittleEndian);
+    EXPECT_EQ(reader.get_int(8), 77);
+}
+
 // ============================================================================
 // FileMgr Tests
 // ============================================================================
@@ -331,6 +549,10 @@ TEST_F(FileMgrTest, ReadNonexistentBlock) {
 
     // Page should remain unchanged or zeroed (implementation dependent)
     // In our implementation, nonexistent blocks leave page as-is
+
+    // Reading does not create the file
+    EXPECT_EQ(fm.length("nonexistent.dat"), 0);
+    EXPECT_FALSE(fm.exists("nonexistent.dat"));
 }
 
 TEST_F(FileMgrTest, OverwriteBlock) {
@@ -424,6 +646,462 @@ TEST_F(FileMgrTest, LargeData) {
     }
 }
 
+TEST_F(FileMgrTest, WritePastEndExtendsLength) {
+    FileMgr fm(test_dir, blocksize);
+
+    fm.append("sparse.dat");
+    EXPECT_EQ(fm.length("sparse.dat"), 1);
+
+    // Writing block 4 directly grows the file to 5 blocks
+    Page page(blocksize);
+    page.set_int(0, 4444);
+    fm.write(BlockId("sparse.dat", 4), page);
+    EXPECT_EQ(fm.length("sparse.dat"), 5);
+
+    Page read_page(blocksize);
+    fm.read(BlockId("sparse.dat", 4), read_page);
+    EXPECT_EQ(read_page.get_int(0), 4444);
+
+    // The in-memory length matches what a fresh FileMgr sees on disk
+    EXPECT_EQ(fs::file_size(test_dir + "/sparse.dat"), 5 * blocksize);
+}
+
+TEST_F(FileMgrTest, ReadPastEndLeavesPageUnchanged) {
+    FileMgr fm(test_dir, blocksize);
+    fm.append("short.dat");
+
+    Page page(blocksize);
+    page.set_int(0, 77);
+    fm.read(BlockId("short.dat", 3), page);
+
+    EXPECT_EQ(page.get_int(0), 77);
+}
+
+TEST_F(FileMgrTest, ConcurrentReadsAndAppends) {
+    FileMgr fm(test_dir, blocksize);
+
+    // Seed a table file whose blocks each carry their own block number
+    const int32_t nblocks = 32;
+    for (int32_t i = 0; i < nblocks; i++) {
+        BlockId blk = fm.append("table.tbl");
+        Page page(blocksize);
+        page.set_int(0, i);
+        fm.write(blk, page);
+    }
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+
+    // Readers on the table file
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            Page page(blocksize);
+            for (int r = 0; r < 500; r++) {
+                int32_t b = (r * 7 + t) % nblocks;
+                fm.read(BlockId("table.tbl", b), page);
+                if (page.get_int(0) != b) mismatches++;
+            }
+        });
+    }
+
+    // Appenders growing the log file concurrently
+    for (int t = 0; t < 2; t++) {
+        threads.emplace_back([&]() {
+            for (int r = 0; r < 100; r++) {
+                fm.append("test.log");
+            }
+        });
+    }
+
+    for (auto& th : threads) th.join();
+
+    EXPECT_EQ(mismatches.load(), 0);
+    EXPECT_EQ(fm.length("table.tbl"), static_cast<size_t>(nblocks));
+    EXPECT_EQ(fm.length("test.log"), 200u);
+    EXPECT_EQ(fs::file_size(test_dir + "/test.log"), 200 * blocksize);
+}
+
+TEST_F(FileMgrTest, ReadRangeFetchesRun) {
+    FileMgr fm(test_dir, blocksize);
+    for (int32_t i = 0; i < 10; i++) {
+        Page page(blocksize);
+        page.set_int(0, i * 3);
+        fm.write(fm.append("run.tbl"), page);
+    }
+
+    std::vector<Page> pages(6, Page(blocksize));
+    for (auto& p : pages) p.set_int(0, -7);
+
+    // Blocks 7..12 requested; only 7..9 exist
+    fm.read_range("run.tbl", 7, pages.size(), pages.data());
+
+    EXPECT_EQ(pages[0].get_int(0), 21);
+    EXPECT_EQ(pages[1].get_int(0), 24);
+    EXPECT_EQ(pages[2].get_int(0), 27);
+    EXPECT_EQ(pages[3].get_int(0), -7);
+    EXPECT_EQ(pages[5].get_int(0), -7);
+
+    // Pointer form, for pages that are not contiguous
+    Page a(blocksize), b(blocksize);
+    Page* ptrs[] = {&a, &b};
+    fm.read_range("run.tbl", 0, 2, ptrs);
+    EXPECT_EQ(a.get_int(0), 0);
+    EXPECT_EQ(b.get_int(0), 3);
+}
+
+TEST_F(FileMgrTest, WriteRangeWritesRun) {
+    FileMgr fm(test_dir, blocksize);
+    fm.append("run.tbl");
+
+    // Blocks 1..4 written past the end of a 1-block file
+    std::vector<Page> pages(4, Page(blocksize));
+    Page* ptrs[4];
+    for (size_t i = 0; i < pages.size(); i++) {
+        pages[i].set_int(0, static_cast<int32_t>(i) + 100);
+        ptrs[i] = &pages[i];
+    }
+    fm.write_range("run.tbl", 1, pages.size(), ptrs);
+    EXPECT_EQ(fm.length("run.tbl"), 5u);
+
+    for (int32_t i = 1; i <= 4; i++) {
+        Page page(blocksize);
+        fm.read(BlockId("run.tbl", i), page);
+        EXPECT_EQ(page.get_int(0), i + 99);
+    }
+}
+
+TEST_F(FileMgrTest, MmapReadsViewMappedBlocks) {
+    FileMgrOptions options;
+    options.mmap_reads = true;
+    const size_t bs = 4096;
+    FileMgr fm(test_dir, bs, options);
+
+    Page page(bs);
+    page.set_int(0, 100);
+    BlockId blk0 = fm.append("mapped.tbl");
+    fm.write(blk0, page);
+
+    Page first(bs);
+    fm.read(blk0, first);
+    EXPECT_TRUE(first.is_view());
+    EXPECT_EQ(first.get_int(0), 100);
+
+    // Grow well past the initial mapping; new blocks force a remap
+    for (int32_t i = 1; i < 600; i++) {
+        BlockId blk = fm.append("mapped.tbl");
+        page.set_int(0, 100 + i);
+        fm.write(blk, page);
+    }
+
+    Page last(bs);
+    fm.read(BlockId("mapped.tbl", 599), last);
+    EXPECT_TRUE(last.is_view());
+    EXPECT_EQ(last.get_int(0), 699);
+
+    // A page viewing the old mapping is still readable
+    EXPECT_EQ(first.get_int(0), 100);
+
+    // Modifying a viewed page does not touch the file until it is written
+    last.set_int(0, -1);
+    Page check(bs);
+    fm.read(BlockId("mapped.tbl", 599), check);
+    EXPECT_EQ(check.get_int(0), 699);
+
+    fm.write(BlockId("mapped.tbl", 599), last);
+    EXPECT_EQ(check.get_int(0), -1);  // writes are visible through the mapping
+}
+
+TEST_F(FileMgrTest, AdviseDoesNotChangeResults) {
+    FileMgr fm(test_dir, blocksize);
+    for (int32_t i = 0; i < 40; i++) {
+        Page page(blocksize);
+        page.set_int(0, i);
+        fm.write(fm.append("hinted.log"), page);
+    }
+
+    fm.advise("hinted.log", AccessHint::Reverse);
+    Page page(blocksize);
+    for (int32_t i = 39; i >= 0; i--) {
+        fm.read(BlockId("hinted.log", i), page);
+        EXPECT_EQ(page.get_int(0), i);
+    }
+
+    fm.advise("hinted.log", AccessHint::Sequential);
+    fm.read(BlockId("hinted.log", 0), page);
+    EXPECT_EQ(page.get_int(0), 0);
+}
+
+TEST_F(FileMgrTest, AppendGrowsInExtents) {
+    FileMgrOptions options;
+    options.extent_size = 16 * blocksize;
+    {
+        FileMgr fm(test_dir, blocksize, options);
+        Page page(blocksize);
+        page.set_int(0, 77);
+        fm.write(fm.append("extent.tbl"), page);
+        for (int i = 1; i < 20; i++) fm.append("extent.tbl");
+
+        // Logical length follows the appends, not the reserved space
+        EXPECT_EQ(fm.length("extent.tbl"), 20u);
+        EXPECT_EQ(fs::file_size(test_dir + "/extent.tbl"), 20 * blocksize);
+
+        Page out(blocksize);
+        fm.read(BlockId("extent.tbl", 0), out);
+        EXPECT_EQ(out.get_int(0), 77);
+        fm.read(BlockId("extent.tbl", 19), out);
+        EXPECT_EQ(out.get_int(0), 0);
+        EXPECT_EQ(out.get_string(100), "");
+    }
+
+    FileMgr fm(test_dir, blocksize, options);
+    EXPECT_EQ(fm.length("extent.tbl"), 20u);
+    EXPECT_EQ(fm.append("extent.tbl").number(), 20);
+}
+
+TEST_F(FileMgrTest, AppendWithoutExtents) {
+    FileMgrOptions options;
+    options.extent_size = 0;
+    FileMgr fm(test_dir, blocksize, options);
+    for (int i = 0; i < 5; i++) fm.append("plain.tbl");
+    EXPECT_EQ(fm.length("plain.tbl"), 5u);
+    EXPECT_EQ(fs::file_size(test_dir + "/plain.tbl"), 5 * blocksize);
+}
+
+TEST_F(FileMgrTest, SyncPolicyFollowsFileClass) {
+    FileMgrOptions options;
+    options.temp_sync = SyncPolicy::None;
+    options.log_sync = SyncPolicy::EveryWrite;
+    options.data_sync = SyncPolicy::Deferred;
+    FileMgr fm(test_dir, blocksize, options);
+
+    EXPECT_EQ(fm.sync_policy("temp1"), SyncPolicy::None);
+    EXPECT_EQ(fm.sync_policy("mudopdb.log"), SyncPolicy::EveryWrite);
+    EXPECT_EQ(fm.sync_policy("students.tbl"), SyncPolicy::Deferred);
+    EXPECT_EQ(fm.sync_policy("catalog"), SyncPolicy::Deferred);
+}
+
+TEST_F(FileMgrTest, DeferredSyncBatchesWrites) {
+    FileMgr fm(test_dir, blocksize);
+    Page page(blocksize);
+    for (int32_t i = 0; i < 10; i++) {
+        fm.write(BlockId("batched.tbl", i), page);
+        fm.write(BlockId("temp_scratch", i), page);
+    }
+    EXPECT_EQ(fm.sync_count(), 0u);
+
+    // One fdatasync for all ten table writes; temp files are never synced
+    fm.sync_all();
+    EXPECT_EQ(fm.sync_count(), 1u);
+
+    // Nothing written since: no further syncs
+    fm.sync("batched.tbl");
+    fm.sync("temp_scratch");
+    EXPECT_EQ(fm.sync_count(), 1u);
+}
+
+TEST_F(FileMgrTest, EveryWriteSyncsEachWrite) {
+    FileMgrOptions options;
+    options.data_sync = SyncPolicy::EveryWrite;
+    FileMgr fm(test_dir, blocksize, options);
+    Page page(blocksize);
+    for (int32_t i = 0; i < 3; i++) {
+        fm.write(BlockId("strict.tbl", i), page);
+    }
+    EXPECT_EQ(fm.sync_count(), 3u);
+    fm.sync("strict.tbl");
+    EXPECT_EQ(fm.sync_count(), 3u);
+}
+
+TEST_F(FileMgrTest, NewDatabaseUsesLittleEndianPages) {
+    {
+        FileMgr fm(test_dir, blocksize);
+        EXPECT_EQ(fm.byte_order(), ByteOrder::LittleEndian);
+        Page page(blocksize);
+        page.set_int(0, 42);
+        fm.write(fm.append("native.tbl"), page);
+    }
+
+    // Reopening keeps the recorded format
+    FileMgr fm(test_dir, blocksize);
+    EXPECT_EQ(fm.byte_order(), ByteOrder::LittleEndian);
+    Page page(blocksize, ByteOrder::BigEndian);
+    fm.read(BlockId("native.tbl", 0), page);
+    EXPECT_EQ(page.byte_order(), ByteOrder::LittleEndian);
+    EXPECT_EQ(page.get_int(0), 42);
+}
+
+TEST_F(FileMgrTest, LegacyDatabaseReadsBigEndianPages) {
+    // A data file written before the page format was versioned
+    fs::create_directories(test_dir);
+    {
+        std::vector<uint8_t> block(blocksize, 0);
+        block[0] = 0x00; block[1] = 0x00; block[2] = 0x01; block[3] = 0x02;  // 258
+        std::ofstream out(test_dir + "/legacy.tbl", std::ios::binary);
+        out.write(reinterpret_cast<const char*>(block.data()), block.size());
+    }
+
+    FileMgr fm(test_dir, blocksize);
+    EXPECT_EQ(fm.byte_order(), ByteOrder::BigEndian);
+
+    Page page(blocksize);
+    fm.read(BlockId("legacy.tbl", 0), page);
+    EXPECT_EQ(page.byte_order(), ByteOrder::BigEndian);
+    EXPECT_EQ(page.get_int(0), 258);
+
+    // Pages built for the other format are rejected rather than corrupting data
+    Page native(blocksize, ByteOrder::LittleEndian);
+    EXPECT_THROW(fm.write(BlockId("legacy.tbl", 0), native), std::invalid_argument);
+
+    page.set_int(4, 7);
+    fm.write(BlockId("legacy.tbl", 0), page);
+    EXPECT_EQ(fm.byte_order(), ByteOrder::BigEndian);
+}
+
+TEST_F(FileMgrTest, DirectIoRoundTrip) {
+    FileMgrOptions options;
+    options.direct_io = true;
+    const size_t direct_blocksize = 4096;
+    {
+        FileMgr fm(test_dir, direct_blocksize, options);
+        for (int32_t i = 0; i < 8; i++) {
+            Page page(direct_blocksize);
+            page.set_int(0, i);
+            page.set_string(100, "direct " + std::to_string(i));
+            fm.write(fm.append("direct.tbl"), page);
+        }
+
+        Page page(direct_blocksize);
+        for (int32_t i = 7; i >= 0; i--) {
+            fm.read(BlockId("direct.tbl", i), page);
+            EXPECT_EQ(page.get_int(0), i);
+            EXPECT_EQ(page.get_string(100), "direct " + std::to_string(i));
+        }
+    }
+
+    // Files written in direct mode are ordinary files to a buffered FileMgr
+    FileMgr fm(test_dir, direct_blocksize);
+    Page page(direct_blocksize);
+    fm.read(BlockId("direct.tbl", 3), page);
+    EXPECT_EQ(page.get_int(0), 3);
+    EXPECT_EQ(fm.length("direct.tbl"), 8u);
+}
+
+TEST_F(FileMgrTest, IsDirectDoesNotCreateFiles) {
+    FileMgrOptions options;
+    options.direct_io = true;
+    FileMgr fm(test_dir, 4096, options);
+
+    EXPECT_FALSE(fm.is_direct("missing.tbl"));
+    EXPECT_FALSE(fs::exists(test_dir + "/missing.tbl"));
+    EXPECT_EQ(fm.length("missing.tbl"), 0u);
+}
+
+TEST_F(FileMgrTest, DirectIoRejectsUnalignedBlockSize) {
+    FileMgrOptions options;
+    options.direct_io = true;
+    FileMgr fm(test_dir, blocksize, options);  // 400 is not a sector multiple
+
+    // Only file systems that accept O_DIRECT validate the block size; on
+    // others the file silently falls back to buffered I/O.
+    try {
+        fm.append("unaligned.tbl");
+        EXPECT_FALSE(fm.is_direct("unaligned.tbl"));
+    } catch (const std::invalid_argument&) {
+        SUCCEED();
+    }
+}
+
+TEST_F(FileMgrTest, DirectIoAndMmapAreExclusive) {
+    FileMgrOptions options;
+    options.direct_io = true;
+    options.mmap_reads = true;
+    EXPECT_THROW(FileMgr(test_dir, blocksize, options), std::invalid_argument);
+}
+
+// ============================================================================
+// Asynchronous I/O Tests
+// ============================================================================
+
+class FileMgrAsyncTest : public FileMgrTest,
+                         public ::testing::WithParamInterface<IoBackendKind> {};
+
+TEST_P(FileMgrAsyncTest, BatchedWriteThenRead) {
+    FileMgrOptions options;
+    options.io_backend = GetParam();
+    options.io_queue_depth = 8;  // smaller than the batch, forcing early submits
+    FileMgr fm(test_dir, blocksize, options);
+
+    const int32_t nblocks = 20;
+    for (int32_t i = 0; i < nblocks; i++) {
+        fm.append("async.dat");
+    }
+
+    std::vector<Page> out;
+    std::vector<IoHandle> handles;
+    out.reserve(nblocks);
+    for (int32_t i = 0; i < nblocks; i++) {
+        out.emplace_back(blocksize);
+        out.back().set_int(0, i * 10);
+        handles.push_back(fm.write_async(BlockId("async.dat", i), out.back()));
+    }
+    fm.submit();
+    for (auto& h : handles) {
+        fm.wait(h);
+        EXPECT_TRUE(h.done());
+    }
+
+    std::vector<Page> in;
+    handles.clear();
+    in.reserve(nblocks);
+    for (int32_t i = 0; i < nblocks; i++) {
+        in.emplace_back(blocksize);
+        handles.push_back(fm.read_async(BlockId("async.dat", i), in.back()));
+    }
+    fm.wait_all();
+
+    for (int32_t i = 0; i < nblocks; i++) {
+        EXPECT_TRUE(handles[i].done());
+        EXPECT_EQ(in[i].get_int(0), i * 10);
+    }
+}
+
+TEST_P(FileMgrAsyncTest, AsyncWriteExtendsLength) {
+    FileMgrOptions options;
+    options.io_backend = GetParam();
+    FileMgr fm(test_dir, blocksize, options);
+
+    Page page(blocksize);
+    page.set_int(0, 5);
+    IoHandle h = fm.write_async(BlockId("grow.dat", 2), page);
+    fm.wait(h);
+
+    EXPECT_EQ(fm.length("grow.dat"), 3);
+
+    // Reading past the end completes immediately and leaves the page alone
+    Page untouched(blocksize);
+    untouched.set_int(0, 99);
+    IoHandle r = fm.read_async(BlockId("grow.dat", 7), untouched);
+    EXPECT_TRUE(r.done());
+    fm.wait(r);
+    EXPECT_EQ(untouched.get_int(0), 99);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, FileMgrAsyncTest,
+                         ::testing::Values(IoBackendKind::Pread, IoBackendKind::IoUring));
+
+TEST_F(FileMgrTest, IoUringRequestReportsActualBackend) {
+    FileMgrOptions options;
+    options.io_backend = IoBackendKind::IoUring;
+    FileMgr fm(test_dir, blocksize, options);
+
+    // Either io_uring is available or the pread fallback is in use
+    IoBackendKind kind = fm.io_backend();
+    EXPECT_TRUE(kind == IoBackendKind::IoUring || kind == IoBackendKind::Pread);
+
+    FileMgr plain(test_dir, blocksize);
+    EXPECT_EQ(plain.io_backend(), IoBackendKind::Pread);
+}
+
 // ============================================================================
 // Integration Tests
 // ============================================================================
@@ -5,6 +5,8 @@
 #include <filesystem>
 #include <string>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 using namespace log;
 using namespace file;
@@ -101,6 +103,20 @@ TEST_F(LogLayerTest, FlushIsIdempotent) {
     lm.flush(0);  // Flush lower LSN - should be no-op
 }
 
+TEST_F(LogLayerTest, FlushSyncsLogFile) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    LogMgr lm(fm, logfile);
+    size_t before = fm->sync_count();
+
+    lm.append(make_record("a"));
+    lm.append(make_record("b"));
+    lm.flush(2);
+    EXPECT_EQ(fm->sync_count(), before + 1);
+
+    lm.flush(2);  // already saved: no second sync
+    EXPECT_EQ(fm->sync_count(), before + 1);
+}
+
 // ============================================================================
 // LogIterator Tests
 // ============================================================================
@@ -342,6 +358,298 @@ TEST_F(LogLayerTest, ManySmallRecords) {
     EXPECT_EQ(count, num_records);
 }
 
+TEST_F(LogLayerTest, ConcurrentAppendsGetDistinctLsns) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    LogMgr lm(fm, logfile);
+
+    const int num_threads = 8;
+    const int per_thread = 200;
+    std::vector<std::vector<size_t>> lsns(num_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < per_thread; i++) {
+                size_t lsn = lm.append(make_record("t" + std::to_string(t) + "r" + std::to_string(i)));
+                lsns[t].push_back(lsn);
+                if (i % 50 == 0) {
+                    lm.flush(lsn);
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    std::vector<size_t> all;
+    for (const auto& v : lsns) all.insert(all.end(), v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), static_cast<size_t>(num_threads * per_thread));
+    for (size_t i = 0; i < all.size(); i++) {
+        EXPECT_EQ(all[i], i + 1);
+    }
+
+    auto iter = lm.iterator();
+    int count = 0;
+    while (iter->has_next()) {
+        iter->next();
+        count++;
+    }
+    EXPECT_EQ(count, num_threads * per_thread);
+}
+
+// ============================================================================
+// Group Commit Tests
+// ============================================================================
+
+TEST_F(LogLayerTest, ConcurrentCommitsShareOneFlush) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    const int num_threads = 8;
+    LogMgrOptions options;
+    options.group_max = num_threads;
+    options.group_wait_us = 10'000'000;  // the group fills long before this
+    LogMgr lm(fm, logfile, options);
+    size_t before = fm->sync_count();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            lm.flush(lm.append(make_record("commit " + std::to_string(t))));
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    LogStats stats = lm.stats();
+    EXPECT_EQ(stats.flush_requests, static_cast<size_t>(num_threads));
+    EXPECT_EQ(stats.group_flushes, 1u);
+    EXPECT_EQ(fm->sync_count(), before + 1);
+}
+
+TEST_F(LogLayerTest, LeaderWaitsAtMostGroupWait) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    LogMgrOptions options;
+    options.group_wait_us = 20'000;
+    LogMgr lm(fm, logfile, options);
+
+    auto start = std::chrono::steady_clock::now();
+    lm.flush(lm.append(make_record("alone")));
+    auto waited = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(waited, std::chrono::microseconds(options.group_wait_us));
+    EXPECT_LT(waited, std::chrono::seconds(5));
+    EXPECT_EQ(lm.stats().group_flushes, 1u);
+}
+
+TEST_F(LogLayerTest, FlushPastLatestLsnReturns) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    LogMgr lm(fm, logfile);
+
+    lm.flush(5);  // nothing appended: nothing to write
+    EXPECT_EQ(lm.stats().group_flushes, 0u);
+
+    lm.append(make_record("one"));
+    lm.flush(100);
+    EXPECT_EQ(lm.stats().group_flushes, 1u);
+}
+
+TEST_F(LogLayerTest, GroupCommittedRecordsSurviveRestart) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    const int num_threads = 8;
+    const int per_thread = 100;
+    {
+        LogMgrOptions options;
+        options.group_wait_us = 200;
+        LogMgr lm(fm, logfile, options);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; t++) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < per_thread; i++) {
+                    lm.flush(lm.append(make_record("t" + std::to_string(t) + "c" + std::to_string(i))));
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        EXPECT_LT(lm.stats().group_flushes, static_cast<size_t>(num_threads * per_thread));
+    }
+
+    // Every commit returned after its record was written
+    LogMgr reopened(fm, logfile);
+    auto iter = reopened.iterator();
+    int count = 0;
+    while (iter->has_next()) {
+        iter->next();
+        count++;
+    }
+    EXPECT_EQ(count, num_threads * per_thread);
+}
+
+// ============================================================================
+// Log Buffer Tests
+// ============================================================================
+
+TEST_F(LogLayerTest, RecordLargerThanBlockThrows) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    LogMgr lm(fm, logfile);
+
+    EXPECT_THROW(lm.append(std::vector<uint8_t>(blocksize - 7, 'x')), std::invalid_argument);
+    EXPECT_EQ(lm.append(std::vector<uint8_t>(blocksize - 8, 'x')), 1u);
+}
+
+TEST_F(LogLayerTest, RingSizeFollowsBufferBytes) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+
+    LogMgrOptions options;
+    options.buffer_bytes = 10 * blocksize + 1;
+    EXPECT_EQ(LogMgr(fm, logfile, options).buffer_blocks(), 10u);
+
+    options.buffer_bytes = 0;  // clamped: one block to append in, one to write
+    EXPECT_EQ(LogMgr(fm, logfile, options).buffer_blocks(), 2u);
+
+    EXPECT_EQ(LogMgr(fm, logfile).buffer_blocks(), LogMgrOptions().buffer_bytes / blocksize);
+}
+
+TEST_F(LogLayerTest, SmallRingKeepsEveryRecord) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    LogMgrOptions options;
+    options.buffer_bytes = 4 * blocksize;
+    LogMgr lm(fm, logfile, options);
+
+    // One record per block: many times as many blocks as the ring holds
+    const size_t records = 20 * lm.buffer_blocks();
+    for (size_t i = 0; i < records; i++) {
+        lm.append(std::vector<uint8_t>(300, static_cast<uint8_t>(i)));
+    }
+    EXPECT_GT(fm->length(logfile), lm.buffer_blocks());
+    EXPECT_EQ(lm.durable_lsn(), 0u);
+
+    auto iter = lm.iterator();
+    EXPECT_EQ(lm.durable_lsn(), records);
+    for (size_t i = records; i > 0; i--) {
+        ASSERT_TRUE(iter->has_next());
+        EXPECT_EQ(iter->next()[0], static_cast<uint8_t>(i - 1));
+    }
+    EXPECT_FALSE(iter->has_next());
+}
+
+TEST_F(LogLayerTest, ReusedRingBlocksHaveZeroedFreeSpace) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    LogMgrOptions options;
+    options.buffer_bytes = 2 * blocksize;
+    LogMgr lm(fm, logfile, options);
+
+    // Large records first, then small ones that close their blocks early,
+    // in ring blocks that held a large record before
+    size_t lsn = 0;
+    for (int i = 0; i < 8; i++) {
+        lsn = lm.append(std::vector<uint8_t>(380, 0xAB));
+    }
+    for (int i = 0; i < 8; i++) {
+        lm.append(std::vector<uint8_t>(100, 0xCD));
+        lsn = lm.append(std::vector<uint8_t>(380, 0xAB));
+    }
+    lm.flush(lsn);
+
+    Page page(blocksize);
+    for (size_t b = 0; b < fm->length(logfile); b++) {
+        fm->read(BlockId(logfile, static_cast<int32_t>(b)), page);
+        auto boundary = static_cast<size_t>(page.get_int(0));
+        const uint8_t* bytes = static_cast<const Page&>(page).contents();
+        EXPECT_TRUE(std::all_of(bytes + 4, bytes + boundary, [](uint8_t x) { return x == 0; }))
+            << "block " << b;
+    }
+}
+
+TEST_F(LogLayerTest, FlusherDrainsClosedBlocksInTheBackground) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    LogMgrOptions options;
+    options.buffer_bytes = 64 * blocksize;
+    LogMgr lm(fm, logfile, options);
+
+    // Fill half the ring: no rollover has to wait, and the flusher writes
+    // closed blocks without being asked
+    const size_t records = lm.buffer_blocks() / 2;
+    for (size_t i = 0; i < records; i++) {
+        lm.append(std::vector<uint8_t>(300, 1));
+    }
+    for (int i = 0; i < 500 && lm.stats().drained_blocks == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    LogStats stats = lm.stats();
+    EXPECT_GT(stats.drained_blocks, 0u);
+    EXPECT_EQ(stats.ring_waits, 0u);
+    EXPECT_EQ(stats.group_flushes, 0u);
+    EXPECT_EQ(lm.durable_lsn(), 0u);  // drained, but not synced
+}
+
+TEST_F(LogLayerTest, FlushWaitsForTheDurableLsn) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    LogMgr lm(fm, logfile);
+
+    size_t lsn = 0;
+    for (int i = 0; i < 30; i++) {
+        lsn = lm.append(make_record("record " + std::to_string(i)));
+    }
+    lm.flush(10);
+    EXPECT_GE(lm.durable_lsn(), 10u);
+    lm.flush(lsn);
+    EXPECT_EQ(lm.durable_lsn(), lsn);
+}
+
+TEST_F(LogLayerTest, ConcurrentAppendsKeepLsnOrder) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    LogMgr lm(fm, logfile);
+
+    // Records of varying size from several threads span many ring laps
+    const int num_threads = 8;
+    const int per_thread = 400;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < per_thread; i++) {
+                std::string rec = std::to_string(t) + ":" + std::to_string(i) +
+                                  std::string(static_cast<size_t>(i % 40), '.');
+                lm.append(make_record(rec));
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    // Backward from the newest record, each thread's records come in
+    // reverse order of appending
+    std::vector<int> next_expected(num_threads, per_thread - 1);
+    auto iter = lm.iterator();
+    int count = 0;
+    while (iter->has_next()) {
+        std::string rec = record_to_string(iter->next());
+        size_t colon = rec.find(':');
+        int t = std::stoi(rec.substr(0, colon));
+        int i = std::stoi(rec.substr(colon + 1));
+        ASSERT_EQ(i, next_expected[t]);
+        next_expected[t]--;
+        count++;
+    }
+    EXPECT_EQ(count, num_threads * per_thread);
+}
+
+TEST_F(LogLayerTest, UnflushedRecordsAreWrittenOnDestruction) {
+    auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
+    {
+        LogMgr lm(fm, logfile);
+        for (int i = 0; i < 50; i++) {
+            lm.append(make_record("record " + std::to_string(i)));
+        }
+    }
+
+    LogMgr reopened(fm, logfile);
+    EXPECT_EQ(reopened.append(make_record("after restart")), 1u);
+    auto iter = reopened.iterator();
+    EXPECT_EQ(record_to_string(iter->next()), "after restart");
+    for (int i = 49; i >= 0; i--) {
+        ASSERT_TRUE(iter->has_next());
+        EXPECT_EQ(record_to_string(iter->next()), "record " + std::to_string(i));
+    }
+    EXPECT_FALSE(iter->has_next());
+}
+
 TEST_F(LogLayerTest, BinaryData) {
     auto fm = std::make_shared<FileMgr>(test_dir, blocksize);
     LogMgr lm(fm, logfile);
@@ -116,6 +116,25 @@ TEST_F(RecordPageTest, SetGetString) {
     bm->unpin(idx);
 }
 
+TEST_F(RecordPageTest, GetStringView) {
+    BlockId blk = fm->append("test.dat");
+    size_t idx = bm->pin(blk);
+    Buffer& buff = bm->buffer(idx);
+
+    RecordPage rp(buff, *layout);
+    rp.format();
+
+    std::optional<size_t> slot = rp.insert_after(std::nullopt);
+    ASSERT_TRUE(slot.has_value());
+    rp.set_string(slot.value(), "name", "Alice");
+
+    std::string_view view = rp.get_string_view(slot.value(), "name");
+    EXPECT_EQ(view, "Alice");
+    EXPECT_EQ(view, rp.get_string(slot.value(), "name"));
+
+    bm->unpin(idx);
+}
+
 TEST_F(RecordPageTest, InsertAfter) {
     BlockId blk = fm->append("test.dat");
     size_t idx = bm->pin(blk);
@@ -332,4 +351,39 @@ TEST_F(RecordPageTest, FieldBoundaries) {
     bm->unpin(idx);
 }
 
+TEST_F(RecordPageTest, ReadAccessReadsButDoesNotModify) {
+    BlockId blk = fm->append("test.dat");
+    size_t idx = bm->pin(blk);
+    Buffer& buff = bm->buffer(idx);
+
+    RecordPage writer(buff, *layout);
+    writer.format();
+    std::optional<size_t> slot = writer.insert_after(std::nullopt);
+    writer.set_int(slot.value(), "id", 5);
+    writer.set_string(slot.value(), "name", "Eve");
+
+    RecordPage reader(buff, *layout, PageAccess::Read);
+    EXPECT_EQ(reader.access(), PageAccess::Read);
+    EXPECT_EQ(reader.next_after(std::nullopt), slot);
+    EXPECT_EQ(reader.get_int(slot.value(), "id"), 5);
+    EXPECT_EQ(reader.get_string(slot.value(), "name"), "Eve");
+
+    // A view stays good until a writer latches the frame
+    EXPECT_EQ(reader.get_string_view(slot.value(), "name"), "Eve");
+    EXPECT_TRUE(reader.release_views());
+    EXPECT_EQ(reader.get_string_view(slot.value(), "name"), "Eve");
+    writer.set_int(slot.value(), "id", 5);
+    EXPECT_FALSE(reader.release_views());
+    EXPECT_TRUE(reader.release_views());
+
+    EXPECT_THROW(reader.set_int(slot.value(), "id", 6), std::logic_error);
+    EXPECT_THROW(reader.set_string(slot.value(), "name", "Bob"), std::logic_error);
+    EXPECT_THROW(reader.delete_record(slot.value()), std::logic_error);
+    EXPECT_THROW(reader.insert_after(slot), std::logic_error);
+    EXPECT_THROW(reader.format(), std::logic_error);
+    EXPECT_EQ(reader.get_int(slot.value(), "id"), 5);
+
+    bm->unpin(idx);
+}
+
 // main() is provided by gtest_main
@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+#include "buffer/buffermgr.hpp"
+#include "buffer/replacementpolicy.hpp"
+#include "file/filemgr.hpp"
+#include "log/logmgr.hpp"
+#include <filesystem>
+#include <memory>
+#include <set>
+
+using namespace buffer;
+using namespace file;
+using namespace log;
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Policy Unit Tests
+// ============================================================================
+
+class ReplacementPolicyTest : public ::testing::TestWithParam<ReplacementKind> {};
+
+TEST_P(ReplacementPolicyTest, ReportsItsKind) {
+    auto policy = make_replacement_policy(GetParam(), 4);
+    EXPECT_EQ(policy->kind(), GetParam());
+}
+
+TEST_P(ReplacementPolicyTest, NeverChoosesPinnedFrames) {
+    auto policy = make_replacement_policy(GetParam(), 4);
+    for (size_t f = 0; f < 4; f++) {
+        policy->loaded(f, BlockId("policy.dat", static_cast<int32_t>(f)));
+    }
+    policy->pinned(0);
+    policy->pinned(1);
+    policy->pinned(3);
+
+    for (int i = 0; i < 5; i++) {
+        auto v = policy->victim();
+        ASSERT_TRUE(v.has_value());
+        EXPECT_EQ(v.value(), 2u);
+    }
+
+    policy->pinned(2);
+    EXPECT_FALSE(policy->victim().has_value());
+
+    policy->unpinned(1);
+    EXPECT_EQ(policy->victim(), std::optional<size_t>(1));
+}
+
+TEST_P(ReplacementPolicyTest, UsesUnassignedFramesFirst) {
+    if (GetParam() == ReplacementKind::Naive) {
+        GTEST_SKIP() << "Naive only looks at frame order";
+    }
+    auto policy = make_replacement_policy(GetParam(), 3);
+    policy->loaded(0, BlockId("policy.dat", 0));
+    policy->accessed(0);
+
+    auto v = policy->victim();
+    ASSERT_TRUE(v.has_value());
+    EXPECT_NE(v.value(), 0u);
+}
+
+TEST_P(ReplacementPolicyTest, RewarmMakesAFrameWarm) {
+    auto policy = make_replacement_policy(GetParam(), 3);
+    policy->loaded(0, BlockId("policy.dat", 0));
+    policy->loaded(1, BlockId("policy.dat", 1));
+    policy->rewarm(0);
+    if (GetParam() == ReplacementKind::Naive) {
+        EXPECT_EQ(policy->warmth(0), 0);  // keeps no history
+    } else {
+        EXPECT_EQ(policy->warmth(0), 1);
+    }
+    if (GetParam() != ReplacementKind::Clock) {
+        EXPECT_EQ(policy->warmth(1), 0);  // Clock sets a bit on every load
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Policies, ReplacementPolicyTest,
+                         ::testing::Values(ReplacementKind::Naive, ReplacementKind::Clock,
+                                           ReplacementKind::LruK, ReplacementKind::TwoQ));
+
+TEST(ReplacementPolicy, ClockGivesReferencedFramesASecondChance) {
+    auto policy = make_replacement_policy(ReplacementKind::Clock, 3);
+    for (size_t f = 0; f < 3; f++) {
+        policy->loaded(f, BlockId("clock.dat", static_cast<int32_t>(f)));
+    }
+    // All referenced: the hand clears every bit and comes back to frame 0
+    EXPECT_EQ(policy->victim(), std::optional<size_t>(0));
+    policy->loaded(0, BlockId("clock.dat", 3));
+
+    // Frame 1 was cleared and not used since; frame 2 is touched again
+    policy->accessed(2);
+    EXPECT_EQ(policy->victim(), std::optional<size_t>(1));
+}
+
+TEST(ReplacementPolicy, LruKEvictsSingleUseFramesFirst) {
+    auto policy = make_replacement_policy(ReplacementKind::LruK, 3);
+    policy->loaded(0, BlockId("lruk.dat", 0));
+    policy->accessed(0);  // two accesses
+    policy->loaded(1, BlockId("lruk.dat", 1));
+    policy->accessed(1);  // two accesses
+    policy->loaded(2, BlockId("lruk.dat", 2));  // one access, but the most recent
+
+    EXPECT_EQ(policy->victim(), std::optional<size_t>(2));
+
+    // Among frames with two accesses, the older second-last access goes first
+    policy->loaded(2, BlockId("lruk.dat", 3));
+    policy->accessed(2);
+    policy->accessed(0);
+    policy->accessed(0);
+    EXPECT_EQ(policy->victim(), std::optional<size_t>(1));
+}
+
+TEST(ReplacementPolicy, TwoQPromotesRememberedBlocks) {
+    auto policy = make_replacement_policy(ReplacementKind::TwoQ, 4);
+    BlockId hot("twoq.dat", 100);
+
+    policy->loaded(0, hot);
+    for (int32_t b = 1; b < 4; b++) {
+        policy->loaded(static_cast<size_t>(b), BlockId("twoq.dat", b));
+    }
+
+    // A1in is over its share, so its oldest frame (the hot block) goes first
+    EXPECT_EQ(policy->victim(), std::optional<size_t>(0));
+    policy->loaded(0, BlockId("twoq.dat", 4));
+
+    // The hot block comes back while it is still in the ghost list: it
+    // enters the main queue and outlives the probationary blocks
+    auto v = policy->victim();
+    ASSERT_TRUE(v.has_value());
+    policy->loaded(v.value(), hot);
+    size_t hot_frame = v.value();
+
+    for (int32_t b = 5; b < 9; b++) {
+        auto victim = policy->victim();
+        ASSERT_TRUE(victim.has_value());
+        EXPECT_NE(victim.value(), hot_frame);
+        policy->loaded(victim.value(), BlockId("twoq.dat", b));
+    }
+}
+
+// ============================================================================
+// BufferMgr With Each Policy
+// ============================================================================
+
+class BufferMgrPolicyTest : public ::testing::TestWithParam<ReplacementKind> {
+protected:
+    std::string test_dir = "/tmp/mudopdb_policy_test";
+    size_t blocksize = 400;
+
+    std::shared_ptr<FileMgr> fm;
+    std::shared_ptr<LogMgr> lm;
+
+    void SetUp() override {
+        if (fs::exists(test_dir)) {
+            fs::remove_all(test_dir);
+        }
+        fs::create_directories(test_dir);
+        fm = std::make_shared<FileMgr>(test_dir, blocksize);
+        lm = std::make_shared<LogMgr>(fm, "test.log");
+    }
+
+    void TearDown() override {
+        if (fs::exists(test_dir)) {
+            fs::remove_all(test_dir);
+        }
+    }
+};
+
+TEST_P(BufferMgrPolicyTest, PinsCorrectBlocksUnderEviction) {
+    BufferMgrOptions options;
+    options.policy = GetParam();
+    BufferMgr bm(fm, lm, 4, options);
+    EXPECT_EQ(bm.replacement_policy(), GetParam());
+
+    const int32_t nblocks = 10;
+    for (int32_t i = 0; i < nblocks; i++) {
+        Page page(blocksize);
+        page.set_int(0, i * 3);
+        fm->write(fm->append("policy.dat"), page);
+    }
+
+    // Keep one block pinned throughout; it must never be evicted
+    size_t held = bm.pin(BlockId("policy.dat", 0));
+
+    for (int round = 0; round < 4; round++) {
+        for (int32_t b = 1; b < nblocks; b++) {
+            int32_t blknum = (b * 7 + round) % (nblocks - 1) + 1;
+            size_t idx = bm.pin(BlockId("policy.dat", blknum));
+            EXPECT_NE(idx, held);
+            EXPECT_EQ(bm.buffer(idx).contents().get_int(0), blknum * 3);
+            bm.unpin(idx);
+        }
+    }
+    EXPECT_EQ(bm.buffer(held).block().value(), BlockId("policy.dat", 0));
+    bm.unpin(held);
+
+    BufferStats stats = bm.stats();
+    EXPECT_EQ(stats.hits + stats.misses, 1u + 4u * (nblocks - 1));
+}
+
+TEST_P(BufferMgrPolicyTest, ExhaustedPoolStillTimesOut) {
+    BufferMgrOptions options;
+    options.policy = GetParam();
+    BufferMgr bm(fm, lm, 2, options);
+    bm.set_max_time(10);
+    size_t a = bm.pin(BlockId("policy.dat", 0));
+    size_t b = bm.pin(BlockId("policy.dat", 1));
+    EXPECT_THROW(bm.pin(BlockId("policy.dat", 2)), BufferAbortException);
+    bm.unpin(a);
+    size_t c = bm.pin(BlockId("policy.dat", 2));
+    EXPECT_EQ(c, a);
+    bm.unpin(b);
+    bm.unpin(c);
+}
+
+TEST_P(BufferMgrPolicyTest, LoadRangeUsesDistinctFrames) {
+    BufferMgrOptions options;
+    options.policy = GetParam();
+    BufferMgr bm(fm, lm, 8, options);
+    for (int32_t i = 0; i < 6; i++) {
+        Page page(blocksize);
+        page.set_int(0, 50 + i);
+        fm->write(fm->append("range.dat"), page);
+    }
+
+    EXPECT_EQ(bm.load_range("range.dat", 0, 6), 6u);
+    std::set<size_t> frames;
+    for (int32_t i = 0; i < 6; i++) {
+        size_t idx = bm.pin(BlockId("range.dat", i));
+        EXPECT_EQ(bm.buffer(idx).contents().get_int(0), 50 + i);
+        frames.insert(idx);
+    }
+    EXPECT_EQ(frames.size(), 6u);
+    EXPECT_EQ(bm.stats().hits, 6u);
+    for (size_t idx : frames) bm.unpin(idx);
+}
+
+INSTANTIATE_TEST_SUITE_P(Policies, BufferMgrPolicyTest,
+                         ::testing::Values(ReplacementKind::Naive, ReplacementKind::Clock,
+                                           ReplacementKind::LruK, ReplacementKind::TwoQ));
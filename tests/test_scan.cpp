@@ -43,6 +43,14 @@ public:
     return "";
   }
 
+  std::string_view get_string_view(const std::string& fldname) override {
+    if (string_data_.count(fldname) && current_position_ >= 0
+        && current_position_ < static_cast<int>(string_data_[fldname].size())) {
+      return string_data_[fldname][current_position_];
+    }
+    return "";
+  }
+
   Constant get_val(const std::string& fldname) override {
     if (int_data_.count(fldname)) {
       return Constant::with_int(get_int(fldname));
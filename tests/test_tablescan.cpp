@@ -153,6 +153,34 @@ TEST_F(TableScanTest, ScanAllRecords) {
     scan.close();
 }
 
+TEST_F(TableScanTest, StringViewMatchesStringAcrossBlocks) {
+    TableScan scan(bm, "students", *layout);
+
+    // Enough records to span several blocks
+    for (int i = 0; i < 60; i++) {
+        scan.insert();
+        scan.set_int("id", i);
+        scan.set_string("name", "Person" + std::to_string(i));
+    }
+
+    scan.before_first();
+    int count = 0;
+    int matches = 0;
+    while (scan.next()) {
+        std::string_view name = scan.get_string_view("name");
+        EXPECT_EQ(name, scan.get_string("name"));
+        EXPECT_EQ(name, "Person" + std::to_string(scan.get_int("id")));
+        if (Constant::with_string("Person42") == name) {
+            matches++;
+        }
+        count++;
+    }
+    EXPECT_EQ(count, 60);
+    EXPECT_EQ(matches, 1);
+
+    scan.close();
+}
+
 TEST_F(TableScanTest, DeleteRecord) {
     TableScan scan(bm, "students", *layout);
 
@@ -324,4 +352,159 @@ TEST_F(TableScanTest, InsertIntoFullPage) {
     scan.close();
 }
 
+TEST_F(TableScanTest, LargeScanRecyclesRingBuffers) {
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    auto pool = std::make_shared<BufferMgr>(fm, lm, 32, options);
+    {
+        TableScan loader(pool, "big", *layout);
+        for (int i = 0; i < 400; i++) {
+            loader.insert();
+            loader.set_int("id", i);
+        }
+        loader.close();
+    }
+    ASSERT_GT(fm->length("big.tbl"), 32u);
+
+    std::vector<std::optional<BlockId>> before;
+    for (size_t i = 0; i < pool->num_buffers(); i++) {
+        before.push_back(pool->buffer(i).block());
+    }
+
+    TableScan scan(pool, "big", *layout);
+    EXPECT_TRUE(scan.uses_ring());
+    int count = 0;
+    while (scan.next()) {
+        EXPECT_EQ(scan.get_int("id"), count);
+        count++;
+    }
+    scan.close();
+    EXPECT_EQ(count, 400);
+
+    // The scan replaced at most its ring (32 / 8 buffers)
+    size_t replaced = 0;
+    for (size_t i = 0; i < pool->num_buffers(); i++) {
+        if (pool->buffer(i).block() != before[i]) {
+            replaced++;
+        }
+    }
+    EXPECT_LE(replaced, 4u);
+    EXPECT_GT(pool->stats().ring_reuses, 0u);
+    EXPECT_EQ(pool->available(), 32u);
+}
+
+TEST_F(TableScanTest, ScanPrefetchesAheadOfItself) {
+    {
+        auto loader_pool = std::make_shared<BufferMgr>(fm, lm, 8);
+        TableScan loader(loader_pool, "ahead", *layout);
+        for (int i = 0; i < 300; i++) {
+            loader.insert();
+            loader.set_int("id", i);
+        }
+        loader.close();
+        loader_pool->flush_all(0);
+    }
+    size_t blocks = fm->length("ahead.tbl");
+    ASSERT_GT(blocks, 8u);
+
+    BufferMgrOptions options;
+    options.policy = ReplacementKind::Clock;
+    // Large enough that the table is not scanned through a ring
+    auto pool = std::make_shared<BufferMgr>(fm, lm, 256, options);
+    TableScan scan(pool, "ahead", *layout);
+    ASSERT_FALSE(scan.uses_ring());
+    scan.before_first();
+    int count = 0;
+    while (scan.next()) {
+        EXPECT_EQ(scan.get_int("id"), count);
+        count++;
+    }
+    scan.close();
+    EXPECT_EQ(count, 300);
+
+    // After the first run, every block was hinted before it was needed
+    BufferStats stats = pool->stats();
+    EXPECT_GT(stats.prefetches, 0u);
+    EXPECT_EQ(stats.misses, 1u);
+}
+
+TEST_F(TableScanTest, SmallTableDoesNotUseRing) {
+    TableScan scan(bm, "students", *layout);
+    EXPECT_FALSE(scan.uses_ring());
+    scan.close();
+}
+
+TEST_F(TableScanTest, ReadOnlyScanSeesInsertedRecords) {
+    TableScan writer(bm, "students", *layout);
+    for (int i = 0; i < 40; i++) {
+        writer.insert();
+        writer.set_int("id", i);
+        writer.set_string("name", "student" + std::to_string(i));
+    }
+    writer.close();
+    ASSERT_GT(fm->length("students.tbl"), 1u);
+
+    TableScan reader(bm, "students", *layout, PageAccess::Read);
+    reader.before_first();
+    int count = 0;
+    while (reader.next()) {
+        EXPECT_EQ(reader.get_int("id"), count);
+        EXPECT_EQ(reader.get_string("name"), "student" + std::to_string(count));
+        count++;
+    }
+    EXPECT_EQ(count, 40);
+
+    reader.before_first();
+    ASSERT_TRUE(reader.next());
+    EXPECT_THROW(reader.set_int("id", 99), std::logic_error);
+    EXPECT_THROW(reader.delete_record(), std::logic_error);
+    EXPECT_THROW(reader.insert(), std::logic_error);
+    reader.close();
+}
+
+TEST_F(TableScanTest, ReadOnlyScanViewsLastUntilNext) {
+    TableScan writer(bm, "students", *layout);
+    for (int i = 0; i < 3; i++) {
+        writer.insert();
+        writer.set_int("id", i);
+        writer.set_string("name", "student" + std::to_string(i));
+    }
+
+    TableScan reader(bm, "students", *layout, PageAccess::Read);
+    reader.before_first();
+    int count = 0;
+    while (reader.next()) {
+        std::string_view name = reader.get_string_view("name");
+        EXPECT_EQ(name, "student" + std::to_string(reader.get_int("id")));
+        count++;
+    }
+    EXPECT_EQ(count, 3);
+
+    // A write to the page while a view is in use is reported by next(),
+    // which leaves the scan where it was
+    reader.before_first();
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.get_string_view("name"), "student0");
+    writer.set_string("name", "changed");  // the writer is on the last record
+    EXPECT_THROW(reader.next(), StaleViewException);
+    EXPECT_EQ(reader.get_int("id"), 0);
+
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.get_string_view("name"), "student1");
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.get_string_view("name"), "changed");
+    EXPECT_FALSE(reader.next());
+    reader.close();
+    writer.close();
+}
+
+TEST_F(TableScanTest, ReadOnlyScanOfEmptyTableCreatesNoBlock) {
+    TableScan reader(bm, "students", *layout, PageAccess::Read);
+    reader.before_first();
+    EXPECT_FALSE(reader.next());
+    reader.close();
+
+    EXPECT_EQ(fm->length("students.tbl"), 0u);
+}
+
 // main() is provided by gtest_main